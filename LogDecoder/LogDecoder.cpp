@@ -0,0 +1,192 @@
+// LogDecoder.cpp : renders a binary log written with -log as text.
+//
+// usage: LogDecoder file [-sites]
+// (-sites adds the file and line each message was logged from)
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "LogFormat.h"
+
+struct Site
+{
+	std::string mFile;
+	uint32_t mLine;
+	std::string mFormat;
+};
+
+template <typename T>
+static bool ReadValue(std::ifstream& file, T& value)
+{
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+static bool ReadString(std::ifstream& file, std::string& s)
+{
+	uint16_t length = 0;
+
+	if (!ReadValue(file, length))
+	{
+		return false;
+	}
+
+	s.resize(length);
+	return length == 0 || static_cast<bool>(file.read(&s[0], length));
+}
+
+int main(int argc, char** argv)
+{
+	const char* fileName = nullptr;
+	bool showSites = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "-sites") == 0)
+		{
+			showSites = true;
+		}
+		else if (!fileName)
+		{
+			fileName = argv[i];
+		}
+	}
+
+	if (!fileName)
+	{
+		std::fprintf(stderr, "usage: %s file [-sites]\n", argv[0]);
+		return 1;
+	}
+
+	std::ifstream file(fileName, std::ios::binary);
+
+	if (!file.is_open())
+	{
+		std::fprintf(stderr, "Failed to open %s\n", fileName);
+		return 1;
+	}
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint64_t frequency = 0;
+
+	if (!ReadValue(file, magic) || !ReadValue(file, version) || !ReadValue(file, frequency) ||
+		magic != LogFormat::Magic || version != LogFormat::Version || frequency == 0)
+	{
+		std::fprintf(stderr, "%s isn't a log this decoder understands\n", fileName);
+		return 1;
+	}
+
+	std::vector<Site> sites;
+	std::vector<uint8_t> record;
+	std::string line;
+	// times are shown from the first record
+	uint64_t firstTicks = 0;
+	bool first = true;
+	int numRecords = 0;
+	int numBad = 0;
+
+	char type = 0;
+
+	while (file.get(type))
+	{
+		if (type == LogFormat::EFormat)
+		{
+			uint16_t id = 0;
+			Site site;
+
+			if (!ReadValue(file, id) || !ReadValue(file, site.mLine) ||
+				!ReadString(file, site.mFile) || !ReadString(file, site.mFormat))
+			{
+				break;
+			}
+
+			if (id >= sites.size())
+			{
+				sites.resize(id + 1);
+			}
+
+			sites[id] = site;
+		}
+		else if (type == LogFormat::EDropped)
+		{
+			uint16_t thread = 0;
+			uint32_t dropped = 0;
+
+			if (!ReadValue(file, thread) || !ReadValue(file, dropped))
+			{
+				break;
+			}
+
+			std::printf("(%u records dropped on thread %u)\n", dropped, thread);
+		}
+		else if (type == LogFormat::ERecord)
+		{
+			uint16_t thread = 0;
+			uint16_t size = 0;
+
+			if (!ReadValue(file, thread) || !ReadValue(file, size) || size < LogFormat::RecordHeaderSize)
+			{
+				break;
+			}
+
+			record.resize(size);
+			std::memcpy(record.data(), &size, 2);
+
+			if (!file.read(reinterpret_cast<char*>(record.data() + 2), size - 2))
+			{
+				break;
+			}
+
+			uint16_t format = 0;
+			uint64_t ticks = 0;
+			std::memcpy(&format, record.data() + 2, 2);
+			std::memcpy(&ticks, record.data() + 4, 8);
+
+			if (first)
+			{
+				firstTicks = ticks;
+				first = false;
+			}
+
+			double ms = static_cast<double>(ticks - firstTicks) * 1000.0 / frequency;
+
+			if (format >= sites.size())
+			{
+				std::printf("[%10.3f] [%u] <unknown format %u>\n", ms, thread, format);
+				numBad++;
+				continue;
+			}
+
+			const Site& site = sites[format];
+
+			if (!LogFormat::Render(site.mFormat.c_str(), record.data() + LogFormat::RecordHeaderSize,
+				size - LogFormat::RecordHeaderSize, line))
+			{
+				numBad++;
+			}
+
+			if (showSites)
+			{
+				std::printf("[%10.3f] [%u] %s:%u: %s\n", ms, thread, site.mFile.c_str(), site.mLine, line.c_str());
+			}
+			else
+			{
+				std::printf("[%10.3f] [%u] %s\n", ms, thread, line.c_str());
+			}
+
+			numRecords++;
+		}
+		else
+		{
+			std::fprintf(stderr, "Unknown entry '%c', stopping\n", type);
+			break;
+		}
+	}
+
+	std::fprintf(stderr, "%d records (%d with arguments that didn't match)\n", numRecords, numBad);
+
+	return 0;
+}
@@ -0,0 +1,341 @@
+// MathBench.cpp : times the Math.h operations the game's hot paths use
+// (Actor::GetForward, MoveComponent, CircleComponent and friends) and
+// prints the cost of each in ns/op and ops/s.
+//
+// usage: MathBench [-filter text] [-ms time] [-csv file]
+// (-filter runs only the benchmarks whose name contains text, -ms is
+// how long to spend on each, and -csv appends the results to a file,
+// tagged with the build configuration so Debug and Release runs of the
+// same code can be compared)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Math.h"
+#include "Random.h"
+
+// inputs cycle through pools this big (a few thousand actors' worth,
+// and small enough to stay in cache, so what's timed is the math)
+static const size_t PoolSize = 4096;
+static const size_t PoolMask = PoolSize - 1;
+
+// every result is folded in here, so none of them can be optimized away
+static volatile unsigned sSink = 0;
+
+struct Inputs
+{
+	// positions across the world, and unit directions
+	std::vector<Vector2> mPositions;
+	std::vector<Vector2> mDirections;
+	std::vector<Vector3> mPoints;
+	std::vector<Vector3> mAxes;
+	// rotations as actors have them, unbounded either way
+	std::vector<float> mAngles;
+	// blend factors, and the values acos and sqrt get
+	std::vector<float> mFractions;
+	std::vector<float> mCosines;
+	std::vector<float> mLengthsSq;
+	// scale, then rotate, then translate (an actor's world transform)
+	std::vector<Matrix3> mTransforms2D;
+	std::vector<Matrix4> mTransforms;
+	std::vector<Quaternion> mRotations;
+};
+
+static void BuildInputs(Inputs& in)
+{
+	Random::Seed(1234);
+
+	for (size_t i = 0; i < PoolSize; i++)
+	{
+		Vector2 position = Random::GetVector(Vector2::Zero, Vector2(1024.0f, 768.0f));
+		float angle = Random::GetFloatRange(-Math::TwoPi, Math::TwoPi);
+		float scale = Random::GetFloatRange(0.5f, 2.0f);
+		Vector3 axis = Vector3::Normalize(Random::GetVector(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f)) + Vector3(0.0f, 0.0f, 0.01f));
+
+		in.mPositions.emplace_back(position);
+		in.mDirections.emplace_back(Math::Cos(angle), Math::Sin(angle));
+		in.mPoints.emplace_back(position.x, position.y, Random::GetFloatRange(-100.0f, 100.0f));
+		in.mAxes.emplace_back(axis);
+		in.mAngles.emplace_back(angle);
+		in.mFractions.emplace_back(Random::GetFloat());
+		in.mCosines.emplace_back(Random::GetFloatRange(-1.0f, 1.0f));
+		in.mLengthsSq.emplace_back(Random::GetFloatRange(0.0f, 1024.0f * 1024.0f));
+		in.mTransforms2D.emplace_back(Matrix3::CreateScale(scale) * Matrix3::CreateRotation(angle) *
+			Matrix3::CreateTranslation(position));
+		in.mTransforms.emplace_back(Matrix4::CreateScale(scale) * Matrix4::CreateRotationZ(angle) *
+			Matrix4::CreateTranslation(in.mPoints.back()));
+		in.mRotations.emplace_back(axis, angle);
+	}
+}
+
+// the optimization level, plus whether asserts are compiled in when
+// that isn't what the level usually implies (NDEBUG alone says nothing
+// about optimization, g++ -O2 without -DNDEBUG is still optimized)
+static const char* GetConfiguration()
+{
+	// (MSVC has no macro for /O2, _DEBUG is what its Debug
+	// configuration sets)
+#if (defined(_MSC_VER) && !defined(__clang__) && !defined(_DEBUG)) || defined(__OPTIMIZE__)
+	const bool optimized = true;
+#else
+	const bool optimized = false;
+#endif
+#ifdef NDEBUG
+	const bool asserts = false;
+#else
+	const bool asserts = true;
+#endif
+
+	if (optimized)
+	{
+		return asserts ? "Release+asserts" : "Release";
+	}
+
+	return asserts ? "Debug" : "Debug-noasserts";
+}
+
+static std::string GetPlatform()
+{
+	char compiler[64];
+#if defined(_MSC_VER) && !defined(__clang__)
+	std::snprintf(compiler, sizeof(compiler), "MSVC %d", _MSC_VER);
+#elif defined(__clang__)
+	std::snprintf(compiler, sizeof(compiler), "clang %d.%d", __clang_major__, __clang_minor__);
+#elif defined(__GNUC__)
+	std::snprintf(compiler, sizeof(compiler), "gcc %d.%d", __GNUC__, __GNUC_MINOR__);
+#else
+	std::snprintf(compiler, sizeof(compiler), "unknown compiler");
+#endif
+
+	std::string platform = compiler;
+	platform += sizeof(void*) == 8 ? " 64-bit" : " 32-bit";
+#if defined(__AVX2__)
+	platform += " AVX2";
+#elif defined(__AVX__)
+	platform += " AVX";
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	platform += " SSE2";
+#endif
+	return platform;
+}
+
+class Runner
+{
+public:
+	Runner(const std::string& filter, double targetMs, FILE* csv)
+		: mFilter(filter)
+		, mTargetMs(targetMs)
+		, mCsv(csv)
+	{
+	}
+
+	// times op(i) over the pools, storing every result (the stores are
+	// part of the cost, but keep the work from being thrown away)
+	template <typename T, typename Op>
+	void Run(const char* name, Op op)
+	{
+		if (!mFilter.empty() && std::strstr(name, mFilter.c_str()) == nullptr)
+		{
+			return;
+		}
+
+		std::vector<T> results(PoolSize);
+
+		// grow the batch until it takes a tenth of the target, then time
+		// five of that size and keep the fastest (the one least disturbed)
+		size_t count = PoolSize;
+
+		while (Time(results, op, count) < mTargetMs / 10.0 && count < (size_t(1) << 34))
+		{
+			count *= 2;
+		}
+
+		double bestMs = Time(results, op, count);
+
+		for (int i = 1; i < 5; i++)
+		{
+			bestMs = std::min(bestMs, Time(results, op, count));
+		}
+
+		double ns = bestMs * 1.0e6 / count;
+		std::printf("%-32s %10.2f ns/op %14.0f ops/s\n", name, ns, 1.0e9 / ns);
+
+		if (mCsv)
+		{
+			std::fprintf(mCsv, "%s,%s,%s,%.3f,%.0f\n", GetConfiguration(), GetPlatform().c_str(), name, ns, 1.0e9 / ns);
+		}
+	}
+
+private:
+	template <typename T, typename Op>
+	static double Time(std::vector<T>& results, Op& op, size_t count)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; i < count; i++)
+		{
+			results[i & PoolMask] = op(i & PoolMask);
+		}
+
+		auto end = std::chrono::steady_clock::now();
+
+		// (after the clock stops)
+		unsigned sum = 0;
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(results.data());
+
+		for (size_t i = 0; i < results.size() * sizeof(T); i++)
+		{
+			sum = sum * 31 + bytes[i];
+		}
+
+		sSink = sSink + sum;
+
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	std::string mFilter;
+	double mTargetMs;
+	FILE* mCsv;
+};
+
+int main(int argc, char** argv)
+{
+	std::string filter;
+	double targetMs = 200.0;
+	const char* csvFile = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+		if (std::strcmp(argv[i], "-filter") == 0 && value)
+		{
+			filter = value;
+			i++;
+		}
+		else if (std::strcmp(argv[i], "-ms") == 0 && value)
+		{
+			targetMs = std::atof(value);
+			i++;
+		}
+		else if (std::strcmp(argv[i], "-csv") == 0 && value)
+		{
+			csvFile = value;
+			i++;
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: MathBench [-filter text] [-ms time] [-csv file]\n");
+			return 1;
+		}
+	}
+
+	FILE* csv = nullptr;
+
+	if (csvFile)
+	{
+		csv = std::fopen(csvFile, "a");
+
+		if (!csv)
+		{
+			std::fprintf(stderr, "Failed to open %s\n", csvFile);
+			return 1;
+		}
+
+		// (a header only for a new file, so runs accumulate)
+		std::fseek(csv, 0, SEEK_END);
+
+		if (std::ftell(csv) == 0)
+		{
+			std::fprintf(csv, "configuration,platform,benchmark,ns_per_op,ops_per_s\n");
+		}
+	}
+
+	Inputs in;
+	BuildInputs(in);
+
+	std::printf("MathBench: %s, %s (%.0f ms per benchmark)\n", GetConfiguration(), GetPlatform().c_str(), targetMs);
+
+	Runner runner(filter, targetMs, csv);
+
+	// what every other line pays just to load and store (subtract it to
+	// compare cheap operations)
+	runner.Run<float>("loop overhead", [&](size_t i) { return in.mAngles[i]; });
+
+	// trig wrappers
+	runner.Run<float>("Math::Sin", [&](size_t i) { return Math::Sin(in.mAngles[i]); });
+	runner.Run<float>("Math::Cos", [&](size_t i) { return Math::Cos(in.mAngles[i]); });
+	runner.Run<float>("Math::Tan", [&](size_t i) { return Math::Tan(in.mAngles[i]); });
+	runner.Run<float>("Math::Acos", [&](size_t i) { return Math::Acos(in.mCosines[i]); });
+	runner.Run<float>("Math::Atan2", [&](size_t i) { return Math::Atan2(in.mDirections[i].y, in.mDirections[i].x); });
+	runner.Run<float>("Math::Sqrt", [&](size_t i) { return Math::Sqrt(in.mLengthsSq[i]); });
+	runner.Run<float>("Math::Fmod", [&](size_t i) { return Math::Fmod(in.mAngles[i], Math::TwoPi); });
+	// (what Actor::GetForward does)
+	runner.Run<Vector2>("forward from rotation", [&](size_t i) { return Vector2(Math::Cos(in.mAngles[i]), -Math::Sin(in.mAngles[i])); });
+
+	// Vector2 (positions and velocities)
+	runner.Run<Vector2>("Vector2 +", [&](size_t i) { return in.mPositions[i] + in.mDirections[i]; });
+	runner.Run<Vector2>("Vector2 * scalar", [&](size_t i) { return in.mDirections[i] * in.mAngles[i]; });
+	// (what MoveComponent does)
+	runner.Run<Vector2>("Vector2 move", [&](size_t i) { return in.mPositions[i] + in.mDirections[i] * 300.0f * in.mFractions[i]; });
+	runner.Run<float>("Vector2::Dot", [&](size_t i) { return Vector2::Dot(in.mPositions[i], in.mDirections[i]); });
+	runner.Run<float>("Vector2::LengthSq", [&](size_t i) { return in.mPositions[i].LengthSq(); });
+	runner.Run<float>("Vector2::Length", [&](size_t i) { return in.mPositions[i].Length(); });
+	runner.Run<Vector2>("Vector2::Normalize", [&](size_t i) { return Vector2::Normalize(in.mPositions[i]); });
+	runner.Run<Vector2>("Vector2::Lerp", [&](size_t i) { return Vector2::Lerp(in.mPositions[i], in.mPositions[(i + 1) & PoolMask], in.mFractions[i]); });
+	runner.Run<Vector2>("Vector2::Transform", [&](size_t i) { return Vector2::Transform(in.mPositions[i], in.mTransforms2D[i]); });
+	// (what CircleComponent's Intersect does)
+	runner.Run<int>("circle intersect", [&](size_t i)
+	{
+		Vector2 diff = in.mPositions[i] - in.mPositions[(i + 1) & PoolMask];
+		return diff.LengthSq() <= 64.0f * 64.0f;
+	});
+
+	// Vector3
+	runner.Run<Vector3>("Vector3 +", [&](size_t i) { return in.mPoints[i] + in.mAxes[i]; });
+	runner.Run<float>("Vector3::Dot", [&](size_t i) { return Vector3::Dot(in.mPoints[i], in.mAxes[i]); });
+	runner.Run<Vector3>("Vector3::Cross", [&](size_t i) { return Vector3::Cross(in.mPoints[i], in.mAxes[i]); });
+	runner.Run<Vector3>("Vector3::Normalize", [&](size_t i) { return Vector3::Normalize(in.mPoints[i]); });
+	runner.Run<Vector3>("Vector3::Transform (Matrix4)", [&](size_t i) { return Vector3::Transform(in.mPoints[i], in.mTransforms[i]); });
+	runner.Run<Vector3>("Vector3::TransformWithPerspDiv", [&](size_t i) { return Vector3::TransformWithPerspDiv(in.mPoints[i], in.mTransforms[i]); });
+	runner.Run<Vector3>("Vector3::Transform (Quat)", [&](size_t i) { return Vector3::Transform(in.mPoints[i], in.mRotations[i]); });
+
+	// matrices
+	runner.Run<Matrix3>("Matrix3 *", [&](size_t i) { return in.mTransforms2D[i] * in.mTransforms2D[(i + 1) & PoolMask]; });
+	runner.Run<Matrix3>("Matrix3::CreateRotation", [&](size_t i) { return Matrix3::CreateRotation(in.mAngles[i]); });
+	runner.Run<Matrix4>("Matrix4 *", [&](size_t i) { return in.mTransforms[i] * in.mTransforms[(i + 1) & PoolMask]; });
+	runner.Run<Matrix4>("Matrix4::Invert", [&](size_t i)
+	{
+		Matrix4 m = in.mTransforms[i];
+		m.Invert();
+		return m;
+	});
+	runner.Run<Matrix4>("Matrix4::CreateRotationZ", [&](size_t i) { return Matrix4::CreateRotationZ(in.mAngles[i]); });
+	runner.Run<Matrix4>("Matrix4::CreateFromQuaternion", [&](size_t i) { return Matrix4::CreateFromQuaternion(in.mRotations[i]); });
+	runner.Run<Matrix4>("Matrix4::CreateLookAt", [&](size_t i) { return Matrix4::CreateLookAt(in.mPoints[i], in.mPoints[(i + 1) & PoolMask], Vector3::UnitZ); });
+	// (an actor's world transform, rebuilt)
+	runner.Run<Matrix4>("world transform", [&](size_t i)
+	{
+		return Matrix4::CreateScale(in.mFractions[i]) * Matrix4::CreateRotationZ(in.mAngles[i]) *
+			Matrix4::CreateTranslation(in.mPoints[i]);
+	});
+
+	// quaternions
+	runner.Run<Quaternion>("Quaternion(axis, angle)", [&](size_t i) { return Quaternion(in.mAxes[i], in.mAngles[i]); });
+	runner.Run<Quaternion>("Quaternion::Normalize", [&](size_t i) { return Quaternion::Normalize(in.mRotations[i]); });
+	runner.Run<Quaternion>("Quaternion::Concatenate", [&](size_t i) { return Quaternion::Concatenate(in.mRotations[i], in.mRotations[(i + 1) & PoolMask]); });
+	runner.Run<Quaternion>("Quaternion::Lerp", [&](size_t i) { return Quaternion::Lerp(in.mRotations[i], in.mRotations[(i + 1) & PoolMask], in.mFractions[i]); });
+	runner.Run<Quaternion>("Quaternion::Slerp", [&](size_t i) { return Quaternion::Slerp(in.mRotations[i], in.mRotations[(i + 1) & PoolMask], in.mFractions[i]); });
+
+	if (csv)
+	{
+		std::fclose(csv);
+	}
+
+	return 0;
+}
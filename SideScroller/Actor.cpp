@@ -2,6 +2,7 @@
 #include "Game.h"
 #include "Component.h"
 #include <algorithm>
+#include "Profiler.h"
 
 Actor::Actor(Game* game)
 	: mState(EActive)
@@ -36,6 +37,20 @@ void Actor::Update(float deltaTime)
 
 void Actor::UpdateComponents(float deltaTime)
 {
+	// (timed per type rather than as a zone each, and only while
+	// capturing, so GetName isn't called otherwise)
+	if (Profiler::IsCapturing())
+	{
+		for (auto comp : mComponents)
+		{
+			Uint64 start = SDL_GetPerformanceCounter();
+			comp->Update(deltaTime);
+			Profiler::AddToTotal(comp->GetName(), SDL_GetPerformanceCounter() - start);
+		}
+
+		return;
+	}
+
 	for (auto comp : mComponents)
 	{
 		comp->Update(deltaTime);
@@ -0,0 +1,144 @@
+#include "AllocTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// running totals (atomic, since worker threads allocate too)
+struct AtomicCounters
+{
+	std::atomic<Uint64> mAllocs;
+	std::atomic<Uint64> mFrees;
+	std::atomic<Uint64> mBytes;
+};
+
+// zero initialized before any constructor runs, so allocations made
+// during static initialization are safe to count
+static AtomicCounters sTotals[AllocTracker::NumScopes];
+static thread_local AllocTracker::Scope sScope = AllocTracker::EOther;
+
+AllocTracker::Counters AllocTracker::sFrame[NumScopes];
+AllocTracker::Counters AllocTracker::sFrameStart[NumScopes];
+
+AllocTracker::ScopeGuard::ScopeGuard(Scope scope)
+	: mPrevious(sScope)
+{
+	sScope = scope;
+}
+
+AllocTracker::ScopeGuard::~ScopeGuard()
+{
+	sScope = mPrevious;
+}
+
+void AllocTracker::EndFrame()
+{
+	for (int i = 0; i < NumScopes; i++)
+	{
+		Counters total = GetTotal(static_cast<Scope>(i));
+
+		sFrame[i].mAllocs = total.mAllocs - sFrameStart[i].mAllocs;
+		sFrame[i].mFrees = total.mFrees - sFrameStart[i].mFrees;
+		sFrame[i].mBytes = total.mBytes - sFrameStart[i].mBytes;
+		sFrameStart[i] = total;
+	}
+}
+
+AllocTracker::Counters AllocTracker::GetFrameTotal()
+{
+	Counters sum = { 0, 0, 0 };
+
+	for (int i = 0; i < NumScopes; i++)
+	{
+		sum.mAllocs += sFrame[i].mAllocs;
+		sum.mFrees += sFrame[i].mFrees;
+		sum.mBytes += sFrame[i].mBytes;
+	}
+
+	return sum;
+}
+
+AllocTracker::Counters AllocTracker::GetTotal(Scope scope)
+{
+	Counters total;
+	total.mAllocs = sTotals[scope].mAllocs.load(std::memory_order_relaxed);
+	total.mFrees = sTotals[scope].mFrees.load(std::memory_order_relaxed);
+	total.mBytes = sTotals[scope].mBytes.load(std::memory_order_relaxed);
+	return total;
+}
+
+const char* AllocTracker::GetScopeName(Scope scope)
+{
+	switch (scope)
+	{
+	case EInput:
+		return "input";
+	case EUpdate:
+		return "update";
+	case ERender:
+		return "render";
+	case EAssets:
+		return "assets";
+	default:
+		return "other";
+	}
+}
+
+void AllocTracker::OnAlloc(size_t bytes)
+{
+	AtomicCounters& counters = sTotals[sScope];
+	counters.mAllocs.fetch_add(1, std::memory_order_relaxed);
+	counters.mBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AllocTracker::OnFree()
+{
+	sTotals[sScope].mFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+#if TRACK_ALLOCATIONS
+
+void* operator new(size_t size)
+{
+	AllocTracker::OnAlloc(size);
+
+	// (new of zero bytes still has to return a unique pointer)
+	void* ptr = std::malloc(size ? size : 1);
+
+	if (!ptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	if (ptr)
+	{
+		AllocTracker::OnFree();
+		std::free(ptr);
+	}
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+#include <SDL.h>
+#include <cstddef>
+
+// replaces global operator new/delete to count heap allocations,
+// split by which part of the frame made them
+// (build with TRACK_ALLOCATIONS=0 to compile the hooks out, leaving
+// every counter at zero)
+#ifndef TRACK_ALLOCATIONS
+#define TRACK_ALLOCATIONS 1
+#endif
+
+class AllocTracker
+{
+public:
+	enum Scope
+	{
+		EInput,
+		EUpdate,
+		ERender,
+		// texture and clip loading, wherever it happens
+		EAssets,
+		// anything outside the others, including worker threads
+		EOther,
+		NumScopes
+	};
+
+	struct Counters
+	{
+		Uint64 mAllocs;
+		Uint64 mFrees;
+		// requested by allocations (frees don't know their size)
+		Uint64 mBytes;
+	};
+
+	// tags this thread's allocations with a scope until it goes
+	// out of scope (they nest, the innermost wins)
+	class ScopeGuard
+	{
+	public:
+		ScopeGuard(Scope scope);
+		~ScopeGuard();
+
+	private:
+		Scope mPrevious;
+	};
+
+	static bool IsEnabled() { return TRACK_ALLOCATIONS != 0; }
+
+	// call once at the end of every frame
+	// (what was counted since the last call becomes "last frame")
+	static void EndFrame();
+
+	// counts for last frame, and for the whole run
+	static const Counters& GetFrame(Scope scope) { return sFrame[scope]; }
+	static Counters GetFrameTotal();
+	static Counters GetTotal(Scope scope);
+
+	static const char* GetScopeName(Scope scope);
+
+	// (called by the operator new/delete replacements)
+	static void OnAlloc(size_t bytes);
+	static void OnFree();
+
+private:
+	static Counters sFrame[NumScopes];
+	static Counters sFrameStart[NumScopes];
+};
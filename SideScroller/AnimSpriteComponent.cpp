@@ -1,37 +1,36 @@
 #include "AnimSpriteComponent.h"
-#include "Math.h"
+#include "AnimationClip.h"
+#include "Actor.h"
+#include "Game.h"
 
 AnimSpriteComponent::AnimSpriteComponent(Actor* owner, int drawOrder)
 	: SpriteComponent(owner, drawOrder)
-	, mCurrFrame(0.0f)
-	, mAnimFPS(24.0f)
+	, mClip(nullptr)
+	, mStartTime(0.0f)
 {
 }
 
-void AnimSpriteComponent::Update(float deltaTime)
+void AnimSpriteComponent::Draw(RenderCommandBuffer& commands)
 {
-	SpriteComponent::Update(deltaTime);
-
-	if (mAnimTextures.size() > 0)
+	if (mClip)
 	{
-		mCurrFrame += mAnimFPS * deltaTime;
-
-		while (mCurrFrame >= mAnimTextures.size())
-		{
-			mCurrFrame -= mAnimTextures.size();
-		}
+		// work out the frame from how long we've been playing,
+		// rather than stepping a frame counter every update
+		float time = mOwner->GetGame()->GetTime() - mStartTime;
+		const AnimationClip::Frame& frame = mClip->GetFrameAt(time);
 
-		SetTexture(mAnimTextures[static_cast<int>(mCurrFrame)]);
+		DrawTexture(commands, frame.mTexture, &frame.mRegion, frame.mRegion.w, frame.mRegion.h);
 	}
 }
 
-void AnimSpriteComponent::SetAnimTextures(const std::vector<SDL_Texture*>& textures)
+void AnimSpriteComponent::SetClip(const AnimationClip* clip)
 {
-	mAnimTextures = textures;
+	mClip = clip;
+	mStartTime = mOwner->GetGame()->GetTime();
 
-	if (mAnimTextures.size() > 0)
+	// so the texture size getters still report something useful
+	if (mClip)
 	{
-		mCurrFrame = 0.0f;
-		SetTexture(mAnimTextures[0]);
+		SetTexture(mClip->GetFrame(0).mTexture);
 	}
 }
@@ -1,24 +1,23 @@
 #pragma once
 #include "SpriteComponent.h"
-#include <vector>
 
 class AnimSpriteComponent : public SpriteComponent
 {
 public:
 	AnimSpriteComponent(class Actor* owner, int drawOrder = 100);
 
-	void Update(float deltaTime) override;
+	const char* GetName() const override { return "AnimSpriteComponent"; }
 
-	void SetAnimTextures(const std::vector<SDL_Texture*>& textures);
+	void Draw(class RenderCommandBuffer& commands) override;
 
-	float GetAnimFPS() const { return mAnimFPS; }
-	void SetAnimFPS(float fps) { mAnimFPS = fps; }
+	// starts playing the clip from its first frame
+	void SetClip(const class AnimationClip* clip);
+	const class AnimationClip* GetClip() const { return mClip; }
 
 private:
-	std::vector<SDL_Texture*> mAnimTextures;
+	// (shared, owned by the game)
+	const class AnimationClip* mClip;
 
-	float mCurrFrame;
-
-	float mAnimFPS;
+	// game time when the clip started playing
+	float mStartTime;
 };
-
@@ -0,0 +1,57 @@
+#include "AnimationClip.h"
+#include "Math.h"
+
+AnimationClip::AnimationClip(const std::vector<Frame>& frames, bool looping)
+	: mFrames(frames)
+	, mInvBucketLength(1.0f)
+	, mLength(0.0f)
+	, mLooping(looping)
+{
+	SDL_assert(!mFrames.empty());
+
+	// buckets as long as the shortest frame
+	float shortest = Math::Infinity;
+
+	for (auto& frame : mFrames)
+	{
+		SDL_assert(frame.mDuration > 0.0f);
+		mLength += frame.mDuration;
+		mEndTimes.emplace_back(mLength);
+		shortest = Math::Min(shortest, frame.mDuration);
+	}
+
+	mInvBucketLength = 1.0f / shortest;
+
+	// the final entry catches times that round up to the length
+	int numBuckets = static_cast<int>(mLength * mInvBucketLength) + 2;
+	int frame = 0;
+
+	for (int i = 0; i < numBuckets; i++)
+	{
+		float start = i * shortest;
+
+		while (frame + 1 < static_cast<int>(mFrames.size()) && start >= mEndTimes[frame])
+		{
+			frame++;
+		}
+
+		mBuckets.emplace_back(frame);
+	}
+
+	// a time past the last end time must never step off the end
+	mEndTimes.back() = Math::Infinity;
+}
+
+float AnimationClip::Wrap(float time) const
+{
+	float length = mLength;
+	time = Math::Fmod(time, length);
+
+	// (fmod keeps the sign of a negative time)
+	if (time < 0.0f)
+	{
+		time += length;
+	}
+
+	return time;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// an immutable sequence of frames shared by every sprite playing it
+// (frames are looked up from a playback time, so sprites don't need
+// to step through the animation each frame)
+class AnimationClip
+{
+public:
+	struct Frame
+	{
+		class Texture* mTexture;
+		// the part of the texture to draw
+		SDL_Rect mRegion;
+		// in seconds
+		float mDuration;
+	};
+
+	AnimationClip(const std::vector<Frame>& frames, bool looping = true);
+
+	// the frame showing time seconds after playback started
+	const Frame& GetFrameAt(float time) const
+	{
+		if (mLooping)
+		{
+			time = Wrap(time);
+		}
+		else
+		{
+			// hold the first/last frame outside the clip
+			time = time < 0.0f ? 0.0f : (time > mLength ? mLength : time);
+		}
+
+		// the bucket gives the frame at its start, and since no frame is
+		// shorter than a bucket at most one step forward is needed
+		int index = mBuckets[static_cast<int>(time * mInvBucketLength)];
+		index += time >= mEndTimes[index];
+
+		return mFrames[index];
+	}
+
+	size_t GetNumFrames() const { return mFrames.size(); }
+	const Frame& GetFrame(size_t index) const { return mFrames[index]; }
+	float GetLength() const { return mLength; }
+	bool IsLooping() const { return mLooping; }
+
+private:
+	float Wrap(float time) const;
+
+	std::vector<Frame> mFrames;
+	// when each frame ends
+	std::vector<float> mEndTimes;
+	// the frame at the start of each bucket of time
+	std::vector<int> mBuckets;
+	float mInvBucketLength;
+	float mLength;
+	bool mLooping;
+};
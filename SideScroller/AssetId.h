@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+
+// identifies an asset file by a 32-bit FNV-1a hash of its path
+// (constexpr, so ids built from string literals are hashed at compile time)
+class AssetId
+{
+public:
+	constexpr AssetId(const char* path)
+		: mPath(path)
+		, mHash(Hash(path))
+	{
+	}
+
+	constexpr const char* GetPath() const { return mPath; }
+	constexpr uint32_t GetHash() const { return mHash; }
+
+	static constexpr uint32_t Hash(const char* str)
+	{
+		uint32_t hash = 2166136261u;
+
+		while (*str)
+		{
+			hash ^= static_cast<uint8_t>(*str++);
+			hash *= 16777619u;
+		}
+
+		// zero is reserved for empty slots in the texture table
+		return hash != 0 ? hash : 1;
+	}
+
+	// mixes another 32-bit value into a hash (for keys built
+	// from several ids)
+	static constexpr uint32_t Combine(uint32_t hash, uint32_t value)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			hash ^= (value >> (i * 8)) & 0xff;
+			hash *= 16777619u;
+		}
+
+		return hash;
+	}
+
+private:
+	const char* mPath;
+	uint32_t mHash;
+};
+
+inline bool operator==(const AssetId& a, const AssetId& b)
+{
+	return a.GetHash() == b.GetHash();
+}
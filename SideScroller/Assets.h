@@ -0,0 +1,16 @@
+#pragma once
+#include "AssetId.h"
+
+// every asset the game requests by name
+namespace Assets
+{
+	constexpr AssetId Asteroid("Assets/Asteroid.png");
+	constexpr AssetId Farback01("Assets/Farback01.png");
+	constexpr AssetId Farback02("Assets/Farback02.png");
+	constexpr AssetId Laser("Assets/Laser.png");
+	constexpr AssetId Ship01("Assets/Ship01.png");
+	constexpr AssetId Ship02("Assets/Ship02.png");
+	constexpr AssetId Ship03("Assets/Ship03.png");
+	constexpr AssetId Ship04("Assets/Ship04.png");
+	constexpr AssetId Stars("Assets/Stars.png");
+}
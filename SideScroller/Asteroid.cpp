@@ -4,20 +4,23 @@
 #include "Game.h"
 #include "Random.h"
 #include "CircleComponent.h"
+#include "Assets.h"
 
 Asteroid::Asteroid(Game* game)
 	: Actor(game)
 	, mCircle(nullptr)
 {
 	// initialize to random position/orientation
-	Vector2 randPos = Random::GetVector(Vector2::Zero, Vector2(1024.0f, 768.0f));
+	Vector2 randPos = Random::GetVector(Vector2::Zero, game->GetWorldSize());
 	SetPosition(randPos);
 
 	SetRotation(Random::GetFloatRange(0.0f, Math::TwoPi));
 
 	// create a sprite component
 	SpriteComponent* sc = new SpriteComponent(this);
-	sc->SetTexture(game->GetTexture("Assets/Asteroid.png"));
+	sc->SetTexture(game->GetTexture(Assets::Asteroid));
+
+	sc->SetRotationSheet(game->GetRotationSheet(Assets::Asteroid, GetSheetSettings()));
 
 	// create a move component and set a forward speed
 	MoveComponent* mc = new MoveComponent(this);
@@ -31,6 +34,14 @@ Asteroid::Asteroid(Game* game)
 	game->AddAsteroid(this);
 }
 
+RotationSheet::Settings Asteroid::GetSheetSettings()
+{
+	// asteroids keep a random angle forever, so 64 steps is plenty
+	RotationSheet::Settings sheet;
+	sheet.mSteps = 64;
+	return sheet;
+}
+
 Asteroid::~Asteroid()
 {
 	GetGame()->RemoveAsteroid(this);
@@ -1,5 +1,6 @@
 #pragma once
 #include "Actor.h"
+#include "RotationSheet.h"
 
 class Asteroid : public Actor
 {
@@ -7,6 +8,9 @@ public:
 	Asteroid(class Game* game);
 	~Asteroid();
 
+	// the rotation sheet asteroids draw from (Game builds it at load time)
+	static RotationSheet::Settings GetSheetSettings();
+
 	class CircleComponent* GetCircle() { return mCircle; }
 
 private:
@@ -1,9 +1,13 @@
 #include "BGSpriteComponent.h"
 #include "Actor.h"
+#include "Game.h"
+#include "Texture.h"
+#include "RenderCommandBuffer.h"
 
 BGSpriteComponent::BGSpriteComponent(Actor* owner, int drawOrder)
 	: SpriteComponent(owner, drawOrder)
-	, mScrollSpeed(0.0f)
+	, mScrollSpeed(Vector2::Zero)
+	, mOffset(Vector2::Zero)
 {
 }
 
@@ -11,59 +15,162 @@ void BGSpriteComponent::Update(float deltaTime)
 {
 	SpriteComponent::Update(deltaTime);
 
-	if (mBGTextures.size() > 0)
+	if (mTiles.size() > 0 && mTileSize.x > 0.0f && mTileSize.y > 0.0f)
 	{
-		for (auto& bg : mBGTextures)
-		{
-			// update the X offset
-			bg.mOffset.x += mScrollSpeed * deltaTime;
+		mOffset += mScrollSpeed * deltaTime;
 
-			// if this is completely off the screen, reset offset to
-			// the right of the last bg texture
-			if (bg.mOffset.x < -mScreenSize.x)
-			{
-				bg.mOffset.x = (mBGTextures.size() - 1) * mScreenSize.x - 1;
-			}
-		}
+		// wrap to one period of the pattern, which is the whole
+		// strip across and a single tile down
+		float stripWidth = mTileSize.x * mTiles.size();
+		mOffset.x = Math::Fmod(mOffset.x, stripWidth);
+		mOffset.y = Math::Fmod(mOffset.y, mTileSize.y);
 	}
+
+	RequestTiles();
 }
 
-void BGSpriteComponent::Draw(SDL_Renderer* renderer)
+void BGSpriteComponent::RequestTiles()
 {
-	// draw each background texture
-	if (mBGTextures.size() > 0)
+	Layout layout;
+
+	if (!GetLayout(layout))
 	{
-		for (auto& bg : mBGTextures)
+		return;
+	}
+
+	// every row shows the same columns, and a column either side of
+	// them is loaded ahead, whichever way the strip scrolls
+	int numTiles = static_cast<int>(mTiles.size());
+	int screenRight = layout.mScreen.x + layout.mScreen.w;
+
+	for (int col = layout.mFirstCol - 1; layout.mOriginX + (col - 1) * layout.mTileW < screenRight; col++)
+	{
+		BGTile& tile = mTiles[((col % numTiles) + numTiles) % numTiles];
+
+		if (!tile.mTexture && !tile.mFailed)
 		{
-			SDL_Rect r;
-			// Assume screen size dimensions
-			r.w = static_cast<int>(mScreenSize.x);
-			r.h = static_cast<int>(mScreenSize.y);
-			// Center the rectangle around the position of the owner
-			r.x = static_cast<int>(mOwner->GetPosition().x - r.w / 2 + bg.mOffset.x);
-			r.y = static_cast<int>(mOwner->GetPosition().y - r.h / 2 + bg.mOffset.y);
-
-			// draw this background
-			SDL_RenderCopy(renderer, bg.mTexture, nullptr, &r);
+			tile.mTexture = mOwner->GetGame()->GetTexture(tile.mId);
+			tile.mFailed = !tile.mTexture;
 		}
 	}
 }
 
-void BGSpriteComponent::SetBGTextures(const std::vector<SDL_Texture*>& textures)
+void BGSpriteComponent::Draw(RenderCommandBuffer& commands)
 {
-	if (textures.size() > 0)
+	Layout layout;
+
+	if (!GetLayout(layout))
 	{
-		int count = 0;
-		
-		for (auto tex : textures)
+		return;
+	}
+
+	const SDL_Rect& screen = layout.mScreen;
+	int tileW = layout.mTileW;
+	int tileH = layout.mTileH;
+	int numTiles = static_cast<int>(mTiles.size());
+
+	for (int row = layout.mFirstRow; layout.mOriginY + row * tileH < screen.y + screen.h; row++)
+	{
+		for (int col = layout.mFirstCol; layout.mOriginX + col * tileW < screen.x + screen.w; col++)
 		{
-			BGTexture temp;
-			temp.mTexture = tex;
-			// each texture is screen width in offset
-			temp.mOffset.x = count * mScreenSize.x;
-			temp.mOffset.y = 0;
-			mBGTextures.emplace_back(temp);
-			count++;
+			// the strip repeats every numTiles columns
+			const BGTile& tile = mTiles[((col % numTiles) + numTiles) % numTiles];
+
+			// (not loaded yet, or failed to load)
+			if (!tile.mTexture)
+			{
+				continue;
+			}
+
+			SDL_Rect r;
+			r.x = layout.mOriginX + col * tileW;
+			r.y = layout.mOriginY + row * tileH;
+			r.w = tileW;
+			r.h = tileH;
+
+			// only copy the part that is actually on screen
+			// (stops the renderer stepping through pixels it
+			// would clip anyway)
+			SDL_Rect visible;
+
+			if (!SDL_IntersectRect(&r, &screen, &visible))
+			{
+				continue;
+			}
+
+			Texture* tex = tile.mTexture;
+
+			if (tex->GetWidth() == r.w && tex->GetHeight() == r.h)
+			{
+				// unscaled, so the source rect is the same
+				// region shifted into texture space
+				SDL_Rect src = visible;
+				src.x -= r.x;
+				src.y -= r.y;
+
+				commands.Draw(tex, &src, visible);
+			}
+			else
+			{
+				// a clipped source rect would round differently
+				// when scaled, so leave clipping to the renderer
+				commands.Draw(tex, nullptr, r);
+			}
 		}
 	}
 }
+
+bool BGSpriteComponent::GetLayout(Layout& outLayout) const
+{
+	if (mTiles.size() == 0 || mTileSize.x < 1.0f || mTileSize.y < 1.0f)
+	{
+		return false;
+	}
+
+	// the part of the screen backgrounds can land on
+	outLayout.mScreen.x = 0;
+	outLayout.mScreen.y = 0;
+	outLayout.mScreen.w = static_cast<int>(mScreenSize.x);
+	outLayout.mScreen.h = static_cast<int>(mScreenSize.y);
+
+	outLayout.mTileW = static_cast<int>(mTileSize.x);
+	outLayout.mTileH = static_cast<int>(mTileSize.y);
+
+	// where tile 0 starts (the strip is laid out from the left
+	// edge of a screen centered on the owner)
+	// every tile is placed from this one rounded origin, so
+	// neighbours always meet exactly and there are no seams
+	outLayout.mOriginX = static_cast<int>(Math::Floor(mOwner->GetPosition().x - mScreenSize.x / 2 + mOffset.x));
+	outLayout.mOriginY = static_cast<int>(Math::Floor(mOwner->GetPosition().y - mScreenSize.y / 2 + mOffset.y));
+
+	outLayout.mFirstCol = Math::FloorDiv(outLayout.mScreen.x - outLayout.mOriginX, outLayout.mTileW);
+	outLayout.mFirstRow = Math::FloorDiv(outLayout.mScreen.y - outLayout.mOriginY, outLayout.mTileH);
+
+	return true;
+}
+
+void BGSpriteComponent::SetBGTextures(const std::vector<AssetId>& tiles)
+{
+	mTiles.clear();
+
+	for (auto& id : tiles)
+	{
+		mTiles.emplace_back(BGTile{ id, nullptr, false });
+	}
+
+	// (the starting view loads with everything else, not mid-game)
+	RequestTiles();
+}
+
+void BGSpriteComponent::SetScreenSize(const Vector2& size)
+{
+	mScreenSize = size;
+
+	// screen-sized tiles unless told otherwise
+	if (mTileSize.x <= 0.0f || mTileSize.y <= 0.0f)
+	{
+		mTileSize = size;
+	}
+
+	RequestTiles();
+}
@@ -2,28 +2,67 @@
 #include "SpriteComponent.h"
 #include <vector>
 #include "Math.h"
+#include "AssetId.h"
 
+// one parallax layer: a strip of tiles that repeats endlessly in
+// both directions and scrolls at its own speed
+// (add one component per layer, ordered by draw order)
 class BGSpriteComponent : public SpriteComponent
 {
 public:
 	BGSpriteComponent(class Actor* owner, int drawOrder = 10);
+	const char* GetName() const override { return "BGSpriteComponent"; }
 	void Update(float deltaTime) override;
-	void Draw(SDL_Renderer* renderer) override;
-	void SetBGTextures(const std::vector<SDL_Texture*>& textures);
-	void SetScreenSize(const Vector2& size) { mScreenSize = size; }
-	void SetScrollSpeed(float speed) { mScrollSpeed = speed; }
-	float GetScrollSpeed() const { return mScrollSpeed; }
+	void Draw(class RenderCommandBuffer& commands) override;
+
+	// the tiles, left to right (only the ones on screen, and a column
+	// either side, are ever requested from the texture cache: those in
+	// the starting view right away, at load time, and the rest in
+	// Update a column before they scroll on, so long strips stream and
+	// Draw stays safe to record on any thread)
+	void SetBGTextures(const std::vector<AssetId>& tiles);
+	void SetScreenSize(const Vector2& size);
+	// (defaults to the screen size)
+	void SetTileSize(const Vector2& size) { mTileSize = size; }
+	void SetScrollSpeed(float speed) { mScrollSpeed = Vector2(speed, 0.0f); }
+	void SetScrollSpeed(const Vector2& speed) { mScrollSpeed = speed; }
+	const Vector2& GetScrollSpeed() const { return mScrollSpeed; }
 
 private:
-	// struct to encapsulate each bg image and its offset
-	struct BGTexture
+	// where the strip lands on screen this frame
+	struct Layout
+	{
+		SDL_Rect mScreen;
+		int mTileW;
+		int mTileH;
+		// top left of tile 0
+		int mOriginX;
+		int mOriginY;
+		// the first column/row of tiles that touches the screen
+		int mFirstCol;
+		int mFirstRow;
+	};
+
+	// false if there is nothing to draw
+	bool GetLayout(Layout& outLayout) const;
+	// requests the textures of the tiles on screen and a column either
+	// side that haven't been yet
+	void RequestTiles();
+
+	struct BGTile
 	{
-		SDL_Texture* mTexture;
-		Vector2 mOffset;
+		AssetId mId;
+		// null until the tile first comes near the screen
+		class Texture* mTexture;
+		// it was requested and didn't load (so it isn't asked for again)
+		bool mFailed;
 	};
 
-	std::vector<BGTexture> mBGTextures;
+	std::vector<BGTile> mTiles;
 	Vector2 mScreenSize;
-	float mScrollSpeed;
+	Vector2 mTileSize;
+	Vector2 mScrollSpeed;
+	// how far the strip has scrolled, wrapped to one strip length
+	// (so it never drifts out of float precision)
+	Vector2 mOffset;
 };
-
@@ -0,0 +1,715 @@
+#include "Benchmark.h"
+#include "Game.h"
+#include "Actor.h"
+#include "AnimSpriteComponent.h"
+#include "Assets.h"
+#include "Asteroid.h"
+#include "BGSpriteComponent.h"
+#include "Laser.h"
+#include "Logger.h"
+#include "BlitKernels.h"
+#include "Random.h"
+#include "Statistics.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+Benchmark::Benchmark(Game* game, const std::string& name, int numFrames, int count)
+	: mGame(game)
+	, mName(name)
+	, mNumFrames(numFrames)
+	, mNumRuns(1)
+	, mRun(0)
+	, mRunFrame(0)
+	, mNeedsReload(false)
+	, mCount(count)
+	, mInputMs(0.0)
+	, mUpdateMs(0.0)
+	, mOutputMs(0.0)
+	, mAllocs()
+	, mCounters(nullptr)
+	, mPhaseCounts()
+	, mCountedFrames(0)
+{
+	mFrameMs.reserve(numFrames);
+}
+
+bool Benchmark::LoadScene()
+{
+	// same world every run
+	Random::Seed(1234);
+	mNeedsReload = false;
+
+	if (mName == "anim")
+	{
+		LoadAnimScene();
+		return true;
+	}
+
+	if (mName == "sprites")
+	{
+		LoadSpriteScene();
+		return true;
+	}
+
+	if (mName == "scenario")
+	{
+		return LoadScenarioScene();
+	}
+
+	LOG("Unknown benchmark: %s", mName.c_str());
+	return false;
+}
+
+// the phases AddFrame gets counts for, in order
+static const char* sPhaseNames[] = { "input", "update", "output" };
+
+void Benchmark::AddFrame(Uint64 inputTicks, Uint64 updateTicks, Uint64 outputTicks,
+	const PerfCounters::Sample* phaseCounts)
+{
+	if (IsDone())
+	{
+		return;
+	}
+
+	if (++mRunFrame == WarmupFrames + mNumFrames)
+	{
+		mRun++;
+		mRunFrame = 0;
+		mNeedsReload = !IsDone();
+	}
+	else if (mRunFrame <= WarmupFrames)
+	{
+		return;
+	}
+
+	double toMs = 1000.0 / SDL_GetPerformanceFrequency();
+
+	mInputMs += inputTicks * toMs;
+	mUpdateMs += updateTicks * toMs;
+	mOutputMs += outputTicks * toMs;
+	mFrameMs.emplace_back(static_cast<float>((inputTicks + updateTicks + outputTicks) * toMs));
+	mInputSamples.emplace_back(static_cast<float>(inputTicks * toMs));
+	mUpdateSamples.emplace_back(static_cast<float>(updateTicks * toMs));
+	mOutputSamples.emplace_back(static_cast<float>(outputTicks * toMs));
+
+	for (int i = 0; i < AllocTracker::NumScopes; i++)
+	{
+		const AllocTracker::Counters& frame = AllocTracker::GetFrame(static_cast<AllocTracker::Scope>(i));
+		mAllocs[i].mAllocs += frame.mAllocs;
+		mAllocs[i].mFrees += frame.mFrees;
+		mAllocs[i].mBytes += frame.mBytes;
+	}
+
+	if (phaseCounts)
+	{
+		for (int phase = 0; phase < 3; phase++)
+		{
+			for (int i = 0; i < PerfCounters::NumCounters; i++)
+			{
+				mPhaseCounts[phase].mValues[i] += phaseCounts[phase].mValues[i];
+			}
+		}
+
+		mCountedFrames++;
+	}
+}
+
+void Benchmark::Report() const
+{
+	if (mFrameMs.empty())
+	{
+		return;
+	}
+
+	std::vector<float> sorted(mFrameMs);
+	std::sort(sorted.begin(), sorted.end());
+
+	size_t n = sorted.size();
+	double total = mInputMs + mUpdateMs + mOutputMs;
+
+	if (mName == "scenario")
+	{
+		LOG("Benchmark scenario %s: %d asteroids, %d animated, %d lasers/s, %d layers, %.0fx%.0f world, %d frames",
+			mScenario.mName.c_str(), mScenario.mAsteroids, mScenario.mAnimSprites, mScenario.mLasersPerSecond,
+			mScenario.mBackgroundLayers, mScenario.mWorldWidth, mScenario.mWorldHeight, static_cast<int>(n));
+	}
+	else
+	{
+		LOG("Benchmark %s: %d x %d frames", mName.c_str(), mCount, static_cast<int>(n));
+	}
+
+	if (mNumRuns > 1)
+	{
+		LOG("  over %d runs", mNumRuns);
+	}
+
+	LOG("  frame  avg %.3f ms  p50 %.3f ms  p99 %.3f ms  (%.1f fps)",
+		total / n, sorted[n / 2], sorted[(n * 99) / 100], n * 1000.0 / total);
+	LOG("  input  avg %.3f ms", mInputMs / n);
+	LOG("  update avg %.3f ms", mUpdateMs / n);
+	LOG("  output avg %.3f ms", mOutputMs / n);
+
+	if (AllocTracker::IsEnabled())
+	{
+		for (int i = 0; i < AllocTracker::NumScopes; i++)
+		{
+			LOG("  allocs/frame %-6s %.1f (%.0f bytes), frees/frame %.1f",
+				AllocTracker::GetScopeName(static_cast<AllocTracker::Scope>(i)),
+				static_cast<double>(mAllocs[i].mAllocs) / n,
+				static_cast<double>(mAllocs[i].mBytes) / n,
+				static_cast<double>(mAllocs[i].mFrees) / n);
+		}
+	}
+
+	if (mCounters && mCountedFrames > 0)
+	{
+		for (int phase = 0; phase < 3; phase++)
+		{
+			const Uint64* counts = mPhaseCounts[phase].mValues;
+			char line[256];
+			int length = SDL_snprintf(line, sizeof(line), "  %-6s", sPhaseNames[phase]);
+
+			for (int i = 0; i < PerfCounters::NumCounters && length < static_cast<int>(sizeof(line)); i++)
+			{
+				length += SDL_snprintf(line + length, sizeof(line) - length, "  %s/frame %.0f",
+					mCounters->GetName(i), static_cast<double>(counts[i]) / mCountedFrames);
+			}
+
+			// (instructions per cycle: low means stalled, on memory or
+			// on mispredicted branches)
+			if (mCounters->IsHardware() && counts[1] > 0 && length < static_cast<int>(sizeof(line)))
+			{
+				SDL_snprintf(line + length, sizeof(line) - length, "  ipc %.2f",
+					static_cast<double>(counts[0]) / counts[1]);
+			}
+
+			LOG("%s", line);
+		}
+	}
+}
+
+bool Benchmark::WriteJson(const std::string& fileName) const
+{
+	std::ofstream file(fileName);
+
+	if (!file.is_open() || mFrameMs.empty())
+	{
+		LOG("Failed to write benchmark results: %s", fileName.c_str());
+		return false;
+	}
+
+	std::vector<float> sorted(mFrameMs);
+	std::sort(sorted.begin(), sorted.end());
+
+	size_t n = sorted.size();
+	double total = mInputMs + mUpdateMs + mOutputMs;
+
+	file << "{\n";
+	file << "  \"name\": \"" << mName << "\",\n";
+	file << "  \"count\": " << mCount << ",\n";
+
+	if (mName == "scenario")
+	{
+		file << "  \"scenario\": \"" << mScenario.mName << "\",\n";
+	}
+
+	file << "  \"frames\": " << n << ",\n";
+	file << "  \"frame_ms\": { \"avg\": " << total / n
+		<< ", \"p50\": " << sorted[n / 2]
+		<< ", \"p99\": " << sorted[(n * 99) / 100] << " },\n";
+	file << "  \"phase_ms\": { \"input\": " << mInputMs / n
+		<< ", \"update\": " << mUpdateMs / n
+		<< ", \"output\": " << mOutputMs / n << " },\n";
+
+	// per frame averages
+	file << "  \"allocations\": {";
+
+	for (int i = 0; i < AllocTracker::NumScopes; i++)
+	{
+		file << (i == 0 ? "\n" : ",\n");
+		file << "    \"" << AllocTracker::GetScopeName(static_cast<AllocTracker::Scope>(i)) << "\": {"
+			<< " \"allocs\": " << static_cast<double>(mAllocs[i].mAllocs) / n
+			<< ", \"frees\": " << static_cast<double>(mAllocs[i].mFrees) / n
+			<< ", \"bytes\": " << static_cast<double>(mAllocs[i].mBytes) / n << " }";
+	}
+
+	file << "\n  }";
+
+	// per frame averages, per phase
+	if (mCounters && mCountedFrames > 0)
+	{
+		file << ",\n  \"counters\": {\n";
+		file << "    \"kind\": \"" << (mCounters->IsHardware() ? "hardware" : "software") << "\"";
+
+		for (int phase = 0; phase < 3; phase++)
+		{
+			file << ",\n    \"" << sPhaseNames[phase] << "\": {";
+
+			for (int i = 0; i < PerfCounters::NumCounters; i++)
+			{
+				file << (i == 0 ? " \"" : ", \"") << mCounters->GetName(i) << "\": "
+					<< static_cast<double>(mPhaseCounts[phase].mValues[i]) / mCountedFrames;
+			}
+
+			file << " }";
+		}
+
+		file << "\n  }";
+	}
+
+	file << "\n";
+	file << "}\n";
+
+	return true;
+}
+
+// writes samples as a JSON array (no trailing newline)
+static void WriteSamples(std::ostream& file, const char* key, const std::vector<float>& samples)
+{
+	file << "  \"" << key << "\": [";
+
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		file << (i % 16 == 0 ? "\n    " : " ") << samples[i] << (i + 1 < samples.size() ? "," : "");
+	}
+
+	file << "\n  ]";
+}
+
+// the array of numbers after "key": in text (just enough JSON to
+// read back what WriteBaseline writes)
+static bool ReadSamples(const std::string& text, const char* key, std::vector<float>& samples)
+{
+	size_t pos = text.find(std::string("\"") + key + "\":");
+
+	if (pos == std::string::npos || (pos = text.find('[', pos)) == std::string::npos)
+	{
+		return false;
+	}
+
+	const char* next = text.c_str() + pos + 1;
+
+	for (;;)
+	{
+		while (*next == ' ' || *next == ',' || *next == '\n' || *next == '\r' || *next == '\t')
+		{
+			next++;
+		}
+
+		if (*next == ']')
+		{
+			return !samples.empty();
+		}
+
+		char* end = nullptr;
+		float sample = std::strtof(next, &end);
+
+		if (end == next)
+		{
+			return false;
+		}
+
+		samples.emplace_back(sample);
+		next = end;
+	}
+}
+
+// the string after "key": in text, or empty
+static std::string ReadString(const std::string& text, const char* key)
+{
+	size_t pos = text.find(std::string("\"") + key + "\":");
+
+	if (pos == std::string::npos || (pos = text.find('"', pos + std::strlen(key) + 3)) == std::string::npos)
+	{
+		return std::string();
+	}
+
+	size_t end = text.find('"', pos + 1);
+	return end == std::string::npos ? std::string() : text.substr(pos + 1, end - pos - 1);
+}
+
+// the number after "key": in text, or zero
+static int ReadInt(const std::string& text, const char* key)
+{
+	size_t pos = text.find(std::string("\"") + key + "\":");
+	return pos == std::string::npos ? 0 : std::atoi(text.c_str() + pos + std::strlen(key) + 3);
+}
+
+// samples cut into runs of equal length, in order
+static std::vector<std::vector<float>> SplitRuns(const std::vector<float>& samples, int runs)
+{
+	std::vector<std::vector<float>> split;
+	size_t perRun = runs > 0 ? samples.size() / runs : 0;
+
+	for (int i = 0; perRun > 0 && i < runs; i++)
+	{
+		split.emplace_back(samples.begin() + i * perRun, samples.begin() + (i + 1) * perRun);
+	}
+
+	return split;
+}
+
+bool Benchmark::WriteBaseline(const std::string& fileName) const
+{
+	std::ofstream file(fileName);
+
+	if (!file.is_open() || mFrameMs.empty())
+	{
+		LOG("Failed to write benchmark baseline: %s", fileName.c_str());
+		return false;
+	}
+
+	file << "{\n";
+	file << "  \"name\": \"" << mName << "\",\n";
+	file << "  \"scenario\": \"" << (mName == "scenario" ? mScenario.mName : std::string()) << "\",\n";
+	file << "  \"count\": " << mCount << ",\n";
+	file << "  \"runs\": " << mNumRuns << ",\n";
+	file << "  \"frames\": " << mFrameMs.size() << ",\n";
+	WriteSamples(file, "frame", mFrameMs);
+	file << ",\n";
+	WriteSamples(file, "input", mInputSamples);
+	file << ",\n";
+	WriteSamples(file, "update", mUpdateSamples);
+	file << ",\n";
+	WriteSamples(file, "output", mOutputSamples);
+	file << "\n}\n";
+
+	LOG("Benchmark baseline written to %s", fileName.c_str());
+	return true;
+}
+
+bool Benchmark::Compare(const std::string& baselineFile, float thresholdPercent) const
+{
+	std::ifstream file(baselineFile);
+
+	if (!file.is_open() || mFrameMs.empty())
+	{
+		LOG("Failed to read benchmark baseline: %s", baselineFile.c_str());
+		return false;
+	}
+
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	std::string text = buffer.str();
+
+	struct Phase
+	{
+		const char* mName;
+		const std::vector<float>* mSamples;
+		std::vector<float> mBaseline;
+	};
+
+	Phase phases[] = {
+		{ "frame", &mFrameMs, {} },
+		{ "input", &mInputSamples, {} },
+		{ "update", &mUpdateSamples, {} },
+		{ "output", &mOutputSamples, {} },
+	};
+
+	for (Phase& phase : phases)
+	{
+		if (!ReadSamples(text, phase.mName, phase.mBaseline))
+		{
+			LOG("Benchmark baseline %s has no %s samples", baselineFile.c_str(), phase.mName);
+			return false;
+		}
+	}
+
+	// a phase regressed when its runs are slower with p < 0.05 and even
+	// the optimistic end of the 95% interval is past the threshold, so
+	// neither noise nor a real but negligible change fails the run
+	const double alpha = 0.05;
+
+	// the tests work on whole runs, and with too few of them even the
+	// clearest slowdown can't reach alpha (3 against 3 can't do better
+	// than 1/20), so that's an error rather than a silent pass
+	int baselineRuns = ReadInt(text, "runs");
+	double smallestP = Statistics::MannWhitneySmallestP(baselineRuns, mNumRuns);
+
+	if (baselineRuns < 1 || smallestP >= alpha)
+	{
+		LOG("Benchmark comparisons need more runs: %d against %d can't give p below %.2f (best %.3f), "
+			"use -bench-runs %d or more on both sides", baselineRuns, mNumRuns, alpha, smallestP, MinBaselineRuns);
+		return false;
+	}
+
+	// (still compared, since a changed scene may be the point)
+	std::string scenario = mName == "scenario" ? mScenario.mName : std::string();
+
+	if (ReadString(text, "name") != mName || ReadString(text, "scenario") != scenario)
+	{
+		LOG("Warning: baseline %s was recorded on a different benchmark", baselineFile.c_str());
+	}
+
+	const int iterations = 1000;
+	double threshold = thresholdPercent / 100.0;
+	bool passed = true;
+
+	LOG("Benchmark vs %s (%d vs %d runs, %d vs %d frames, threshold %.1f%%):", baselineFile.c_str(),
+		baselineRuns, mNumRuns, static_cast<int>(phases[0].mBaseline.size()), static_cast<int>(mFrameMs.size()),
+		thresholdPercent);
+	LOG("  %-6s %-3s %9s %9s %8s %19s %8s  %s", "phase", "", "base ms", "new ms", "diff", "95% CI", "p", "");
+
+	for (const Phase& phase : phases)
+	{
+		std::vector<std::vector<float>> beforeRuns = SplitRuns(phase.mBaseline, baselineRuns);
+		std::vector<std::vector<float>> afterRuns = SplitRuns(*phase.mSamples, mNumRuns);
+		const float percentiles[] = { 50.0f, 99.0f };
+		const char* labels[] = { "p50", "p99" };
+
+		for (int i = 0; i < 2; i++)
+		{
+			float before = Statistics::Percentile(phase.mBaseline, percentiles[i]);
+			float after = Statistics::Percentile(*phase.mSamples, percentiles[i]);
+			double change = before > 0.0f ? (after - before) / before : 0.0;
+
+			// each run's percentile is one sample
+			std::vector<float> beforeByRun;
+			std::vector<float> afterByRun;
+
+			for (const std::vector<float>& run : beforeRuns)
+			{
+				beforeByRun.emplace_back(Statistics::Percentile(run, percentiles[i]));
+			}
+
+			for (const std::vector<float>& run : afterRuns)
+			{
+				afterByRun.emplace_back(Statistics::Percentile(run, percentiles[i]));
+			}
+
+			double p = Statistics::MannWhitneyGreater(beforeByRun, afterByRun);
+			double low = 0.0;
+			double high = 0.0;
+			Statistics::BootstrapPercentileChange(beforeRuns, afterRuns, percentiles[i], iterations, low, high);
+
+			bool regressed = p < alpha && low > threshold;
+			passed = passed && !regressed;
+
+			LOG("  %-6s %-3s %9.3f %9.3f %+7.1f%% [%+7.1f%%, %+7.1f%%] %8.4f  %s",
+				i == 0 ? phase.mName : "", labels[i], before, after, change * 100.0,
+				low * 100.0, high * 100.0, p, regressed ? "REGRESSED" : "ok");
+		}
+	}
+
+	LOG("Benchmark %s", passed ? "passed" : "regressed");
+	return passed;
+}
+
+void Benchmark::LoadAnimScene()
+{
+	// every sprite shares one clip, so this measures the per-sprite
+	// cost of looking up and drawing the current frame
+	const AnimationClip* clip = mGame->GetAnimClip({
+		Assets::Ship01,
+		Assets::Ship02,
+		Assets::Ship03,
+		Assets::Ship04,
+	}, 24.0f);
+
+	for (int i = 0; i < mCount; i++)
+	{
+		Actor* actor = new Actor(mGame);
+		actor->SetPosition(Random::GetVector(Vector2::Zero, Vector2(1024.0f, 768.0f)));
+
+		AnimSpriteComponent* asc = new AnimSpriteComponent(actor);
+		asc->SetClip(clip);
+	}
+}
+
+void Benchmark::LoadSpriteScene()
+{
+	// moving, rotated, alpha-blended sprites (the slowest kind of blit),
+	// to compare SDL's renderer against -cpu-raster
+	for (int i = 0; i < mCount; i++)
+	{
+		new Asteroid(mGame);
+	}
+}
+
+// fires lasers from random places in the world at a steady rate
+class LaserSpawner : public Actor
+{
+public:
+	LaserSpawner(Game* game, int perSecond)
+		: Actor(game)
+		, mInterval(1.0f / perSecond)
+		, mTimer(0.0f)
+	{
+	}
+
+	void UpdateActor(float deltaTime) override
+	{
+		for (mTimer += deltaTime; mTimer >= mInterval; mTimer -= mInterval)
+		{
+			Laser* laser = new Laser(GetGame());
+			laser->SetPosition(Random::GetVector(Vector2::Zero, GetGame()->GetWorldSize()));
+			laser->SetRotation(Random::GetFloatRange(0.0f, Math::TwoPi));
+		}
+	}
+
+private:
+	float mInterval;
+	float mTimer;
+};
+
+bool Benchmark::LoadScenarioScene()
+{
+	if (!mScenario.Load(mScenarioDescription.empty() ? "1k" : mScenarioDescription))
+	{
+		return false;
+	}
+
+	mCount = mScenario.GetNumEntities();
+	mGame->SetWorldSize(Vector2(mScenario.mWorldWidth, mScenario.mWorldHeight));
+
+	// parallax layers cycle through the two backgrounds, each faster
+	// than the one behind it
+	Actor* background = new Actor(mGame);
+	background->SetPosition(Vector2(512.0f, 384.0f));
+
+	for (int i = 0; i < mScenario.mBackgroundLayers; i++)
+	{
+		BGSpriteComponent* bg = new BGSpriteComponent(background, 10 + i);
+		bg->SetScreenSize(Vector2(1024.0f, 768.0f));
+
+		if (i % 2 == 0)
+		{
+			bg->SetBGTextures({ Assets::Farback01, Assets::Farback02 });
+		}
+		else
+		{
+			bg->SetBGTextures({ Assets::Stars });
+		}
+
+		bg->SetScrollSpeed(-100.0f * (i + 1));
+	}
+
+	for (int i = 0; i < mScenario.mAsteroids; i++)
+	{
+		new Asteroid(mGame);
+	}
+
+	const AnimationClip* clip = mGame->GetAnimClip({
+		Assets::Ship01,
+		Assets::Ship02,
+		Assets::Ship03,
+		Assets::Ship04,
+	}, 24.0f);
+
+	for (int i = 0; i < mScenario.mAnimSprites; i++)
+	{
+		Actor* actor = new Actor(mGame);
+		actor->SetPosition(Random::GetVector(Vector2::Zero, mGame->GetWorldSize()));
+
+		AnimSpriteComponent* asc = new AnimSpriteComponent(actor);
+		asc->SetClip(clip);
+	}
+
+	if (mScenario.mLasersPerSecond > 0)
+	{
+		new LaserSpawner(mGame, mScenario.mLasersPerSecond);
+	}
+
+	return true;
+}
+
+int Benchmark::RunBlitKernels(int count)
+{
+	Random::Seed(1234);
+
+	// a random premultiplied source, with plenty of fully transparent
+	// and fully opaque texels since the kernels treat those specially
+	const int srcSize = 64;
+	std::vector<Uint32> texels(srcSize * srcSize);
+
+	for (Uint32& texel : texels)
+	{
+		int a = Random::GetIntRange(-64, 319);
+		a = Math::Clamp(a, 0, 255);
+		Uint32 r = Random::GetIntRange(0, a);
+		Uint32 g = Random::GetIntRange(0, a);
+		Uint32 b = Random::GetIntRange(0, a);
+		texel = (static_cast<Uint32>(a) << 24) | (r << 16) | (g << 8) | b;
+	}
+
+	// random rows: any scale, any angle, starting anywhere near the source
+	// (in 16.16 fixed point)
+	const int one = 65536;
+	const int maxCount = 257;
+	std::vector<BlitRow> rows(count);
+	std::vector<Uint32> background(maxCount);
+
+	for (BlitRow& row : rows)
+	{
+		row.mTexels = texels.data();
+		row.mTexPitch = srcSize;
+		row.mSrcW = Random::GetIntRange(1, srcSize);
+		row.mSrcH = Random::GetIntRange(1, srcSize);
+		row.mU = Random::GetIntRange(-8 * one, (srcSize + 8) * one);
+		row.mV = Random::GetIntRange(-8 * one, (srcSize + 8) * one);
+		row.mDu = Random::GetIntRange(-4 * one, 4 * one);
+		row.mDv = Random::GetIntRange(-4 * one, 4 * one);
+		row.mDst = nullptr;
+		row.mCount = Random::GetIntRange(0, maxCount);
+	}
+
+	for (Uint32& pixel : background)
+	{
+		pixel = static_cast<Uint32>(Random::GetIntRange(0, 0x7fffffff)) | 0xff000000;
+	}
+
+	const BlitKernels::Filter filters[] = { BlitKernels::ENearest, BlitKernels::EBilinear };
+	const char* filterNames[] = { "nearest", "bilinear" };
+	BlitKernels::Isa best = BlitKernels::GetBestIsa();
+
+	std::vector<Uint32> expected(maxCount);
+	std::vector<Uint32> actual(maxCount);
+	int failures = 0;
+
+	for (int f = 0; f < 2; f++)
+	{
+		for (int isa = BlitKernels::EScalar; isa <= best; isa++)
+		{
+			BlitKernels::RowFunc reference = BlitKernels::GetRowFunc(filters[f], BlitKernels::EScalar);
+			BlitKernels::RowFunc kernel = BlitKernels::GetRowFunc(filters[f], static_cast<BlitKernels::Isa>(isa));
+
+			Uint64 ticks = 0;
+			Uint64 pixels = 0;
+			int mismatches = 0;
+
+			for (BlitRow row : rows)
+			{
+				std::copy(background.begin(), background.end(), expected.begin());
+				std::copy(background.begin(), background.end(), actual.begin());
+
+				row.mDst = expected.data();
+				reference(row);
+
+				row.mDst = actual.data();
+				Uint64 start = SDL_GetPerformanceCounter();
+				kernel(row);
+				ticks += SDL_GetPerformanceCounter() - start;
+				pixels += row.mCount;
+
+				// (including the pixels past the row, which must be untouched)
+				if (!std::equal(expected.begin(), expected.end(), actual.begin()))
+				{
+					mismatches++;
+				}
+			}
+
+			double ns = ticks * 1.0e9 / SDL_GetPerformanceFrequency();
+
+			SDL_Log("Blit %s %s: %.3f ns/pixel, %d of %d rows mismatched",
+				filterNames[f], BlitKernels::GetIsaName(static_cast<BlitKernels::Isa>(isa)),
+				pixels ? ns / pixels : 0.0, mismatches, count);
+
+			failures += mismatches;
+		}
+	}
+
+	return failures != 0 ? 1 : 0;
+}
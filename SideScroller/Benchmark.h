@@ -0,0 +1,93 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "AllocTracker.h"
+#include "PerfCounters.h"
+#include "Scenario.h"
+
+// runs the game headless for a fixed number of frames on a
+// synthetic scene, then reports how long each phase took (and,
+// given a baseline, whether that got significantly slower)
+class Benchmark
+{
+public:
+	Benchmark(class Game* game, const std::string& name, int numFrames, int count);
+
+	// what the "scenario" benchmark builds (see Scenario)
+	void SetScenario(const std::string& description) { mScenarioDescription = description; }
+	// rebuild the scene and measure numFrames again this many times
+	void SetRuns(int runs) { mNumRuns = runs; }
+	// report these counters too (see AddFrame)
+	void SetCounters(const PerfCounters* counters) { mCounters = counters; }
+
+	// builds the benchmark's world, returns false if the name is unknown
+	bool LoadScene();
+	// a run just finished and another follows, so the world needs
+	// clearing and LoadScene calling again
+	bool NeedsReload() const { return mNeedsReload; }
+
+	// record one frame's phase times (in performance counter ticks),
+	// allocations (so call it after AllocTracker::EndFrame) and, with
+	// SetCounters, each phase's counts (input, update, output)
+	void AddFrame(Uint64 inputTicks, Uint64 updateTicks, Uint64 outputTicks,
+		const PerfCounters::Sample* phaseCounts = nullptr);
+	bool IsDone() const { return mRun >= mNumRuns; }
+
+	void Report() const;
+	// the same results, plus allocations per scope, for scripts
+	bool WriteJson(const std::string& fileName) const;
+
+	// every frame's phase times, for Compare to test later runs against
+	bool WriteBaseline(const std::string& fileName) const;
+	// prints how each phase's p50 and p99 moved since the baseline,
+	// returns false if any got slower by more than thresholdPercent
+	// with confidence, judged run by run (or the baseline couldn't be
+	// read, or there are too few runs to judge)
+	bool Compare(const std::string& baselineFile, float thresholdPercent) const;
+	// the fewest runs a baseline comparison can judge with (4 against 4
+	// can just reach p < 0.05, see Compare)
+	static const int MinBaselineRuns = 4;
+
+	// checks every SIMD blit kernel against the scalar reference on
+	// count random rows and times them, returns non-zero on a mismatch
+	static int RunBlitKernels(int count);
+
+private:
+	void LoadAnimScene();
+	void LoadSpriteScene();
+	bool LoadScenarioScene();
+
+	// frames at the start of every run left out of the results
+	// (while caches and the frame arena warm up)
+	static const int WarmupFrames = 10;
+
+	class Game* mGame;
+	std::string mName;
+	int mNumFrames;
+	int mNumRuns;
+	int mRun;
+	// frames into the current run, including warm-up
+	int mRunFrame;
+	bool mNeedsReload;
+	// how many of the benchmarked thing to spawn
+	int mCount;
+	std::string mScenarioDescription;
+	Scenario mScenario;
+
+	// per frame, in milliseconds
+	std::vector<float> mFrameMs;
+	std::vector<float> mInputSamples;
+	std::vector<float> mUpdateSamples;
+	std::vector<float> mOutputSamples;
+	// totals
+	double mInputMs;
+	double mUpdateMs;
+	double mOutputMs;
+	// summed over every frame
+	AllocTracker::Counters mAllocs[AllocTracker::NumScopes];
+	const PerfCounters* mCounters;
+	PerfCounters::Sample mPhaseCounts[3];
+	// (frames whose counters read, what mPhaseCounts averages over)
+	int mCountedFrames;
+};
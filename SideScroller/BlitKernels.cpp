@@ -0,0 +1,428 @@
+#include "BlitKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLIT_X86 1
+#include <immintrin.h>
+#endif
+
+// gcc and clang only allow AVX2 intrinsics in functions marked for it
+// (msvc allows them anywhere)
+#if defined(__GNUC__) || defined(__clang__)
+#define BLIT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BLIT_TARGET_AVX2
+#endif
+
+// x / 255 rounded, exact for x up to 255 * 255
+static inline Uint32 Div255(Uint32 x)
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+// premultiplied src over dst
+static inline Uint32 Over(Uint32 src, Uint32 dst)
+{
+	Uint32 inv = 255 - (src >> 24);
+	Uint32 result = 0;
+
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		Uint32 s = (src >> shift) & 0xff;
+		Uint32 d = (dst >> shift) & 0xff;
+		result |= (s + Div255(d * inv)) << shift;
+	}
+
+	return result;
+}
+
+// the texel at (x, y), transparent outside the source region
+static inline Uint32 Fetch(const BlitRow& row, int x, int y)
+{
+	if (static_cast<unsigned>(x) >= static_cast<unsigned>(row.mSrcW) ||
+		static_cast<unsigned>(y) >= static_cast<unsigned>(row.mSrcH))
+	{
+		return 0;
+	}
+
+	return row.mTexels[y * row.mTexPitch + x];
+}
+
+// the bilinear sample at 16.16 position (u, v)
+static inline Uint32 SampleBilinear(const BlitRow& row, int u, int v)
+{
+	// texel centers are at +0.5
+	u -= 0x8000;
+	v -= 0x8000;
+
+	int x = u >> 16;
+	int y = v >> 16;
+	Uint32 fx = (u >> 8) & 0xff;
+	Uint32 fy = (v >> 8) & 0xff;
+
+	Uint32 t00 = Fetch(row, x, y);
+	Uint32 t10 = Fetch(row, x + 1, y);
+	Uint32 t01 = Fetch(row, x, y + 1);
+	Uint32 t11 = Fetch(row, x + 1, y + 1);
+
+	Uint32 result = 0;
+
+	for (int shift = 0; shift < 32; shift += 8)
+	{
+		Uint32 top = (((t00 >> shift) & 0xff) * (256 - fx) + ((t10 >> shift) & 0xff) * fx) >> 8;
+		Uint32 bottom = (((t01 >> shift) & 0xff) * (256 - fx) + ((t11 >> shift) & 0xff) * fx) >> 8;
+		result |= ((top * (256 - fy) + bottom * fy) >> 8) << shift;
+	}
+
+	return result;
+}
+
+void BlitKernels::NearestScalar(const BlitRow& row)
+{
+	int u = row.mU;
+	int v = row.mV;
+
+	for (int i = 0; i < row.mCount; i++, u += row.mDu, v += row.mDv)
+	{
+		Uint32 texel = Fetch(row, u >> 16, v >> 16);
+
+		// (a transparent texel leaves dst as it is)
+		if (texel != 0)
+		{
+			row.mDst[i] = Over(texel, row.mDst[i]);
+		}
+	}
+}
+
+void BlitKernels::BilinearScalar(const BlitRow& row)
+{
+	int u = row.mU;
+	int v = row.mV;
+
+	for (int i = 0; i < row.mCount; i++, u += row.mDu, v += row.mDv)
+	{
+		Uint32 texel = SampleBilinear(row, u, v);
+
+		if (texel != 0)
+		{
+			row.mDst[i] = Over(texel, row.mDst[i]);
+		}
+	}
+}
+
+#ifdef BLIT_X86
+
+// premultiplied src over dst for 4 pixels
+static inline __m128i Over4(__m128i src, __m128i dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c255 = _mm_set1_epi16(255);
+	const __m128i c128 = _mm_set1_epi16(128);
+
+	// two pixels per register, as 16-bit channels
+	__m128i sLo = _mm_unpacklo_epi8(src, zero);
+	__m128i sHi = _mm_unpackhi_epi8(src, zero);
+	__m128i dLo = _mm_unpacklo_epi8(dst, zero);
+	__m128i dHi = _mm_unpackhi_epi8(dst, zero);
+
+	// 255 - alpha, copied across each pixel's channels
+	__m128i invLo = _mm_sub_epi16(c255, _mm_shufflehi_epi16(_mm_shufflelo_epi16(sLo, 0xff), 0xff));
+	__m128i invHi = _mm_sub_epi16(c255, _mm_shufflehi_epi16(_mm_shufflelo_epi16(sHi, 0xff), 0xff));
+
+	// Div255(dst * inv), same rounding as the scalar version
+	__m128i xLo = _mm_add_epi16(_mm_mullo_epi16(dLo, invLo), c128);
+	__m128i xHi = _mm_add_epi16(_mm_mullo_epi16(dHi, invHi), c128);
+	xLo = _mm_srli_epi16(_mm_add_epi16(xLo, _mm_srli_epi16(xLo, 8)), 8);
+	xHi = _mm_srli_epi16(_mm_add_epi16(xHi, _mm_srli_epi16(xHi, 8)), 8);
+
+	return _mm_packus_epi16(_mm_add_epi16(sLo, xLo), _mm_add_epi16(sHi, xHi));
+}
+
+// (a + (b - a) * w) for 16-bit channels, w in [0, 256] per channel
+static inline __m128i Lerp4(__m128i a, __m128i b, __m128i w)
+{
+	const __m128i c256 = _mm_set1_epi16(256);
+	return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(a, _mm_sub_epi16(c256, w)), _mm_mullo_epi16(b, w)), 8);
+}
+
+// bilinear filter of four taps for 4 pixels, fx/fy one per 32-bit lane
+static inline __m128i Bilinear4(__m128i t00, __m128i t10, __m128i t01, __m128i t11, __m128i fx, __m128i fy)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	// spread each pixel's weight over its four 16-bit channels
+	__m128i wx = _mm_or_si128(fx, _mm_slli_epi32(fx, 16));
+	__m128i wy = _mm_or_si128(fy, _mm_slli_epi32(fy, 16));
+	__m128i wxLo = _mm_unpacklo_epi32(wx, wx);
+	__m128i wxHi = _mm_unpackhi_epi32(wx, wx);
+	__m128i wyLo = _mm_unpacklo_epi32(wy, wy);
+	__m128i wyHi = _mm_unpackhi_epi32(wy, wy);
+
+	__m128i topLo = Lerp4(_mm_unpacklo_epi8(t00, zero), _mm_unpacklo_epi8(t10, zero), wxLo);
+	__m128i topHi = Lerp4(_mm_unpackhi_epi8(t00, zero), _mm_unpackhi_epi8(t10, zero), wxHi);
+	__m128i botLo = Lerp4(_mm_unpacklo_epi8(t01, zero), _mm_unpacklo_epi8(t11, zero), wxLo);
+	__m128i botHi = Lerp4(_mm_unpackhi_epi8(t01, zero), _mm_unpackhi_epi8(t11, zero), wxHi);
+
+	return _mm_packus_epi16(Lerp4(topLo, botLo, wyLo), Lerp4(topHi, botHi, wyHi));
+}
+
+static void NearestSSE2(const BlitRow& row)
+{
+	int i = 0;
+
+	// there's no gather before AVX2, so texels are fetched one by one
+	// and only the blending is done 4 wide
+	for (; i + 4 <= row.mCount; i += 4)
+	{
+		int u = row.mU + i * row.mDu;
+		int v = row.mV + i * row.mDv;
+
+		__m128i src = _mm_setr_epi32(
+			static_cast<int>(Fetch(row, u >> 16, v >> 16)),
+			static_cast<int>(Fetch(row, (u + row.mDu) >> 16, (v + row.mDv) >> 16)),
+			static_cast<int>(Fetch(row, (u + 2 * row.mDu) >> 16, (v + 2 * row.mDv) >> 16)),
+			static_cast<int>(Fetch(row, (u + 3 * row.mDu) >> 16, (v + 3 * row.mDv) >> 16)));
+
+		__m128i* dst = reinterpret_cast<__m128i*>(row.mDst + i);
+		_mm_storeu_si128(dst, Over4(src, _mm_loadu_si128(dst)));
+	}
+
+	// the leftover pixels
+	BlitRow tail = row;
+	tail.mU += i * row.mDu;
+	tail.mV += i * row.mDv;
+	tail.mDst += i;
+	tail.mCount -= i;
+	BlitKernels::NearestScalar(tail);
+}
+
+static void BilinearSSE2(const BlitRow& row)
+{
+	int i = 0;
+
+	for (; i + 4 <= row.mCount; i += 4)
+	{
+		alignas(16) Uint32 t00[4];
+		alignas(16) Uint32 t10[4];
+		alignas(16) Uint32 t01[4];
+		alignas(16) Uint32 t11[4];
+		alignas(16) Uint32 fx[4];
+		alignas(16) Uint32 fy[4];
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			int u = row.mU + (i + lane) * row.mDu - 0x8000;
+			int v = row.mV + (i + lane) * row.mDv - 0x8000;
+			int x = u >> 16;
+			int y = v >> 16;
+
+			t00[lane] = Fetch(row, x, y);
+			t10[lane] = Fetch(row, x + 1, y);
+			t01[lane] = Fetch(row, x, y + 1);
+			t11[lane] = Fetch(row, x + 1, y + 1);
+			fx[lane] = (u >> 8) & 0xff;
+			fy[lane] = (v >> 8) & 0xff;
+		}
+
+		__m128i src = Bilinear4(
+			_mm_load_si128(reinterpret_cast<const __m128i*>(t00)),
+			_mm_load_si128(reinterpret_cast<const __m128i*>(t10)),
+			_mm_load_si128(reinterpret_cast<const __m128i*>(t01)),
+			_mm_load_si128(reinterpret_cast<const __m128i*>(t11)),
+			_mm_load_si128(reinterpret_cast<const __m128i*>(fx)),
+			_mm_load_si128(reinterpret_cast<const __m128i*>(fy)));
+
+		__m128i* dst = reinterpret_cast<__m128i*>(row.mDst + i);
+		_mm_storeu_si128(dst, Over4(src, _mm_loadu_si128(dst)));
+	}
+
+	BlitRow tail = row;
+	tail.mU += i * row.mDu;
+	tail.mV += i * row.mDv;
+	tail.mDst += i;
+	tail.mCount -= i;
+	BlitKernels::BilinearScalar(tail);
+}
+
+// premultiplied src over dst for 8 pixels
+BLIT_TARGET_AVX2 static inline __m256i Over8(__m256i src, __m256i dst)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i c255 = _mm256_set1_epi16(255);
+	const __m256i c128 = _mm256_set1_epi16(128);
+
+	__m256i sLo = _mm256_unpacklo_epi8(src, zero);
+	__m256i sHi = _mm256_unpackhi_epi8(src, zero);
+	__m256i dLo = _mm256_unpacklo_epi8(dst, zero);
+	__m256i dHi = _mm256_unpackhi_epi8(dst, zero);
+
+	__m256i invLo = _mm256_sub_epi16(c255, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(sLo, 0xff), 0xff));
+	__m256i invHi = _mm256_sub_epi16(c255, _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(sHi, 0xff), 0xff));
+
+	__m256i xLo = _mm256_add_epi16(_mm256_mullo_epi16(dLo, invLo), c128);
+	__m256i xHi = _mm256_add_epi16(_mm256_mullo_epi16(dHi, invHi), c128);
+	xLo = _mm256_srli_epi16(_mm256_add_epi16(xLo, _mm256_srli_epi16(xLo, 8)), 8);
+	xHi = _mm256_srli_epi16(_mm256_add_epi16(xHi, _mm256_srli_epi16(xHi, 8)), 8);
+
+	return _mm256_packus_epi16(_mm256_add_epi16(sLo, xLo), _mm256_add_epi16(sHi, xHi));
+}
+
+BLIT_TARGET_AVX2 static inline __m256i Lerp8(__m256i a, __m256i b, __m256i w)
+{
+	const __m256i c256 = _mm256_set1_epi16(256);
+	return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(a, _mm256_sub_epi16(c256, w)), _mm256_mullo_epi16(b, w)), 8);
+}
+
+// gathers the texels at (x, y) for 8 pixels, transparent outside the source
+BLIT_TARGET_AVX2 static inline __m256i Gather8(const BlitRow& row, __m256i x, __m256i y)
+{
+	const __m256i minusOne = _mm256_set1_epi32(-1);
+
+	__m256i inside = _mm256_and_si256(
+		_mm256_and_si256(_mm256_cmpgt_epi32(x, minusOne), _mm256_cmpgt_epi32(_mm256_set1_epi32(row.mSrcW), x)),
+		_mm256_and_si256(_mm256_cmpgt_epi32(y, minusOne), _mm256_cmpgt_epi32(_mm256_set1_epi32(row.mSrcH), y)));
+
+	// (masked off lanes aren't read, but keep their index harmless anyway)
+	__m256i index = _mm256_add_epi32(_mm256_mullo_epi32(y, _mm256_set1_epi32(row.mTexPitch)), x);
+	index = _mm256_and_si256(index, inside);
+
+	return _mm256_mask_i32gather_epi32(_mm256_setzero_si256(),
+		reinterpret_cast<const int*>(row.mTexels), index, inside, 4);
+}
+
+BLIT_TARGET_AVX2 static void NearestAVX2(const BlitRow& row)
+{
+	const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	__m256i stepU = _mm256_mullo_epi32(lanes, _mm256_set1_epi32(row.mDu));
+	__m256i stepV = _mm256_mullo_epi32(lanes, _mm256_set1_epi32(row.mDv));
+
+	int i = 0;
+
+	for (; i + 8 <= row.mCount; i += 8)
+	{
+		__m256i u = _mm256_add_epi32(_mm256_set1_epi32(row.mU + i * row.mDu), stepU);
+		__m256i v = _mm256_add_epi32(_mm256_set1_epi32(row.mV + i * row.mDv), stepV);
+
+		__m256i src = Gather8(row, _mm256_srai_epi32(u, 16), _mm256_srai_epi32(v, 16));
+
+		__m256i* dst = reinterpret_cast<__m256i*>(row.mDst + i);
+		_mm256_storeu_si256(dst, Over8(src, _mm256_loadu_si256(dst)));
+	}
+
+	BlitRow tail = row;
+	tail.mU += i * row.mDu;
+	tail.mV += i * row.mDv;
+	tail.mDst += i;
+	tail.mCount -= i;
+	NearestSSE2(tail);
+}
+
+BLIT_TARGET_AVX2 static void BilinearAVX2(const BlitRow& row)
+{
+	const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i fracMask = _mm256_set1_epi32(0xff);
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i stepU = _mm256_mullo_epi32(lanes, _mm256_set1_epi32(row.mDu));
+	__m256i stepV = _mm256_mullo_epi32(lanes, _mm256_set1_epi32(row.mDv));
+
+	int i = 0;
+
+	for (; i + 8 <= row.mCount; i += 8)
+	{
+		// texel centers are at +0.5
+		__m256i u = _mm256_add_epi32(_mm256_set1_epi32(row.mU + i * row.mDu - 0x8000), stepU);
+		__m256i v = _mm256_add_epi32(_mm256_set1_epi32(row.mV + i * row.mDv - 0x8000), stepV);
+		__m256i x = _mm256_srai_epi32(u, 16);
+		__m256i y = _mm256_srai_epi32(v, 16);
+		__m256i x1 = _mm256_add_epi32(x, one);
+		__m256i y1 = _mm256_add_epi32(y, one);
+
+		__m256i t00 = Gather8(row, x, y);
+		__m256i t10 = Gather8(row, x1, y);
+		__m256i t01 = Gather8(row, x, y1);
+		__m256i t11 = Gather8(row, x1, y1);
+
+		__m256i fx = _mm256_and_si256(_mm256_srai_epi32(u, 8), fracMask);
+		__m256i fy = _mm256_and_si256(_mm256_srai_epi32(v, 8), fracMask);
+		__m256i wx = _mm256_or_si256(fx, _mm256_slli_epi32(fx, 16));
+		__m256i wy = _mm256_or_si256(fy, _mm256_slli_epi32(fy, 16));
+		__m256i wxLo = _mm256_unpacklo_epi32(wx, wx);
+		__m256i wxHi = _mm256_unpackhi_epi32(wx, wx);
+		__m256i wyLo = _mm256_unpacklo_epi32(wy, wy);
+		__m256i wyHi = _mm256_unpackhi_epi32(wy, wy);
+
+		__m256i topLo = Lerp8(_mm256_unpacklo_epi8(t00, zero), _mm256_unpacklo_epi8(t10, zero), wxLo);
+		__m256i topHi = Lerp8(_mm256_unpackhi_epi8(t00, zero), _mm256_unpackhi_epi8(t10, zero), wxHi);
+		__m256i botLo = Lerp8(_mm256_unpacklo_epi8(t01, zero), _mm256_unpacklo_epi8(t11, zero), wxLo);
+		__m256i botHi = Lerp8(_mm256_unpackhi_epi8(t01, zero), _mm256_unpackhi_epi8(t11, zero), wxHi);
+
+		__m256i src = _mm256_packus_epi16(Lerp8(topLo, botLo, wyLo), Lerp8(topHi, botHi, wyHi));
+
+		__m256i* dst = reinterpret_cast<__m256i*>(row.mDst + i);
+		_mm256_storeu_si256(dst, Over8(src, _mm256_loadu_si256(dst)));
+	}
+
+	BlitRow tail = row;
+	tail.mU += i * row.mDu;
+	tail.mV += i * row.mDv;
+	tail.mDst += i;
+	tail.mCount -= i;
+	BilinearSSE2(tail);
+}
+
+#endif
+
+BlitKernels::Isa BlitKernels::GetBestIsa()
+{
+#ifdef BLIT_X86
+	if (SDL_HasAVX2())
+	{
+		return EAVX2;
+	}
+
+	if (SDL_HasSSE2())
+	{
+		return ESSE2;
+	}
+#endif
+
+	return EScalar;
+}
+
+const char* BlitKernels::GetIsaName(Isa isa)
+{
+	switch (isa)
+	{
+	case ESSE2:
+		return "sse2";
+	case EAVX2:
+		return "avx2";
+	default:
+		return "scalar";
+	}
+}
+
+BlitKernels::RowFunc BlitKernels::GetRowFunc(Filter filter, Isa isa)
+{
+	Isa best = GetBestIsa();
+
+	if (isa > best)
+	{
+		isa = best;
+	}
+
+#ifdef BLIT_X86
+	if (isa == EAVX2)
+	{
+		return filter == EBilinear ? BilinearAVX2 : NearestAVX2;
+	}
+
+	if (isa == ESSE2)
+	{
+		return filter == EBilinear ? BilinearSSE2 : NearestSSE2;
+	}
+#endif
+
+	return filter == EBilinear ? BilinearScalar : NearestScalar;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <SDL.h>
+
+// one row of a rotated, scaled sprite blit into an ARGB8888 target
+// (source coordinates step in 16.16 fixed point and all the blending
+// is integer math, so every kernel produces exactly the same pixels)
+struct BlitRow
+{
+	// premultiplied ARGB8888, the top left of the source region
+	const Uint32* mTexels;
+	int mTexPitch;
+	int mSrcW;
+	int mSrcH;
+	// source position of the first pixel's center, and the step per pixel
+	int mU;
+	int mV;
+	int mDu;
+	int mDv;
+
+	Uint32* mDst;
+	int mCount;
+};
+
+// scalar reference kernels plus SSE2/AVX2 versions, picked at runtime
+class BlitKernels
+{
+public:
+	enum Filter
+	{
+		ENearest,
+		EBilinear
+	};
+
+	enum Isa
+	{
+		EScalar,
+		ESSE2,
+		EAVX2
+	};
+
+	typedef void (*RowFunc)(const BlitRow& row);
+
+	// the widest instruction set this CPU (and build) supports
+	static Isa GetBestIsa();
+	static const char* GetIsaName(Isa isa);
+
+	// (falls back to narrower kernels if isa isn't available)
+	static RowFunc GetRowFunc(Filter filter, Isa isa);
+
+	// premultiplied "over" of each sampled texel onto the row
+	static void NearestScalar(const BlitRow& row);
+	static void BilinearScalar(const BlitRow& row);
+};
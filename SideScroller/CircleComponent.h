@@ -7,6 +7,8 @@ class CircleComponent : public Component
 public:
 	CircleComponent(class Actor* owner);
 
+	const char* GetName() const override { return "CircleComponent"; }
+
 	void SetRadius(float radius) { mRadius = radius; }
 	float GetRadius() const;
 
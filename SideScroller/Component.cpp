@@ -1,16 +1,20 @@
 #include "Component.h"
 #include "Actor.h"
 
+int Component::sCount = 0;
+
 Component::Component(Actor* owner, int updateOrder)
 	: mOwner(owner)
 	, mUpdateOrder(updateOrder)
 {
 	mOwner->AddComponent(this);
+	sCount++;
 }
 
 Component::~Component()
 {
 	mOwner->RemoveComponent(this);
+	sCount--;
 }
 
 void Component::Update(float deltaTime)
@@ -11,11 +11,20 @@ public:
 	virtual void Update(float deltaTime);
 	virtual void ProcessInput(const uint8_t* keyState) {}
 
+	// the component's type, for the profiler
+	virtual const char* GetName() const { return "Component"; }
+
 	int GetUpdateOrder() const { return mUpdateOrder; }
 
+	// how many components exist right now, for the HUD
+	static int GetCount() { return sCount; }
+
 protected:
 	class Actor* mOwner;
 
 	int mUpdateOrder;
+
+private:
+	static int sCount;
 };
 
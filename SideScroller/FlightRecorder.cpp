@@ -0,0 +1,313 @@
+#include "FlightRecorder.h"
+#include <csignal>
+#include "FrameStats.h"
+#include "Math.h"
+#include "Logger.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+FlightRecorder* FlightRecorder::sActive = nullptr;
+
+// signals that end the game, dumped before they do
+static const int sFatalSignals[] = { SIGSEGV, SIGILL, SIGFPE, SIGABRT };
+
+// stall dumps per session, so a bad run doesn't fill the disk
+static const int MaxDumps = 8;
+// (how long after Initialize stall dumps arm)
+static const Uint64 ArmDelayUs = 1000000;
+
+// low level file writing, which is safe from a signal handler
+// (unlike stdio and iostreams)
+static int OpenDumpFile(const char* fileName)
+{
+#ifdef _WIN32
+	return _open(fileName, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+	return open(fileName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+}
+
+static void WriteDumpFile(int file, const char* data, size_t size)
+{
+#ifdef _WIN32
+	_write(file, data, static_cast<unsigned>(size));
+#else
+	// (a short write just loses the rest, this is best effort)
+	ssize_t written = write(file, data, size);
+	(void)written;
+#endif
+}
+
+static void CloseDumpFile(int file)
+{
+#ifdef _WIN32
+	_close(file);
+#else
+	close(file);
+#endif
+}
+
+// text is built here, a line at a time, without snprintf
+class DumpWriter
+{
+public:
+	DumpWriter(int file)
+		: mFile(file)
+		, mSize(0)
+	{
+	}
+
+	~DumpWriter()
+	{
+		Flush();
+	}
+
+	void Text(const char* text)
+	{
+		for (; *text; text++)
+		{
+			Char(*text);
+		}
+	}
+
+	void Number(Uint64 value)
+	{
+		char digits[20];
+		int count = 0;
+
+		do
+		{
+			digits[count++] = static_cast<char>('0' + value % 10);
+			value /= 10;
+		} while (value > 0);
+
+		while (count > 0)
+		{
+			Char(digits[--count]);
+		}
+	}
+
+	void Hex(const Uint8* bytes, int count)
+	{
+		static const char hex[] = "0123456789abcdef";
+
+		for (int i = 0; i < count; i++)
+		{
+			Char(hex[bytes[i] >> 4]);
+			Char(hex[bytes[i] & 15]);
+		}
+	}
+
+	void Char(char c)
+	{
+		if (mSize == sizeof(mBuffer))
+		{
+			Flush();
+		}
+
+		mBuffer[mSize++] = c;
+	}
+
+	void Flush()
+	{
+		WriteDumpFile(mFile, mBuffer, mSize);
+		mSize = 0;
+	}
+
+private:
+	int mFile;
+	char mBuffer[4096];
+	size_t mSize;
+};
+
+FlightRecorder::FlightRecorder()
+	: mCount(0)
+	, mStartCounter(0)
+	, mStallMs(0.0f)
+	, mFramesUntilArmed(0)
+	, mNumDumps(0)
+{
+}
+
+FlightRecorder::~FlightRecorder()
+{
+	Shutdown();
+}
+
+bool FlightRecorder::Initialize(int numFrames, float stallMs)
+{
+	// (all the memory the recorder will use, up front)
+	mFrames.assign(numFrames, Frame());
+	mCount = 0;
+	mStartCounter = SDL_GetPerformanceCounter();
+	mStallMs = stallMs;
+	mFramesUntilArmed = 0;
+	mNumDumps = 0;
+
+	sActive = this;
+
+	for (int signal : sFatalSignals)
+	{
+		std::signal(signal, &FlightRecorder::OnFatalSignal);
+	}
+
+	return true;
+}
+
+void FlightRecorder::Shutdown()
+{
+	if (sActive != this)
+	{
+		return;
+	}
+
+	for (int signal : sFatalSignals)
+	{
+		std::signal(signal, SIG_DFL);
+	}
+
+	sActive = nullptr;
+}
+
+void FlightRecorder::AddFrame(const FrameStats& stats, const Uint8* keyState)
+{
+	if (mFrames.empty())
+	{
+		return;
+	}
+
+	float frameMs = stats.GetFrameTime(0);
+	Uint64 endUs = (SDL_GetPerformanceCounter() - mStartCounter) * 1000000 / SDL_GetPerformanceFrequency();
+	Uint64 frameUs = static_cast<Uint64>(frameMs * 1000.0f);
+
+	Frame& frame = mFrames[mCount % mFrames.size()];
+	frame.mFrame = mCount + 1;
+	frame.mStartUs = static_cast<Uint32>(endUs > frameUs ? endUs - frameUs : 0);
+	frame.mFrameUs = static_cast<Uint32>(frameUs);
+	frame.mInputUs = static_cast<Uint32>(stats.mInputMs * 1000.0f);
+	frame.mUpdateUs = static_cast<Uint32>(stats.mUpdateMs * 1000.0f);
+	frame.mRenderUs = static_cast<Uint32>(stats.mRenderMs * 1000.0f);
+	frame.mActors = stats.mActors;
+	frame.mSprites = stats.mSprites;
+	frame.mComponents = stats.mComponents;
+	frame.mDrawCalls = stats.mDrawCalls;
+	frame.mTextureSwitches = stats.mTextureSwitches;
+	frame.mAllocs = static_cast<Uint32>(stats.mAllocs);
+	frame.mAllocBytes = stats.mAllocBytes;
+
+	for (int i = 0; i < KeyCount / 8; i++)
+	{
+		Uint8 bits = 0;
+
+		for (int bit = 0; bit < 8; bit++)
+		{
+			bits |= keyState[i * 8 + bit] ? (1 << bit) : 0;
+		}
+
+		frame.mKeys[i] = bits;
+	}
+
+	mCount = mCount + 1;
+
+	// (the first second loads things, however many frames that is)
+	if (endUs < ArmDelayUs)
+	{
+		return;
+	}
+
+	if (mFramesUntilArmed > 0)
+	{
+		mFramesUntilArmed--;
+		return;
+	}
+
+	if (mStallMs > 0.0f && frameMs > mStallMs && mNumDumps < MaxDumps)
+	{
+		char fileName[64];
+		char reason[64];
+		SDL_snprintf(fileName, sizeof(fileName), "flight_stall_%u.csv", frame.mFrame);
+		SDL_snprintf(reason, sizeof(reason), "stall of %.2f ms on frame %u", frameMs, frame.mFrame);
+
+		if (Dump(fileName, reason))
+		{
+			Uint32 count = mCount;
+			LOG("Flight recorder: %s, dumped %u frames to %s",
+				reason, Math::Min<Uint32>(count, static_cast<Uint32>(mFrames.size())), fileName);
+		}
+
+		// (the next dump gets a whole new window of frames)
+		mNumDumps++;
+		mFramesUntilArmed = static_cast<int>(mFrames.size());
+	}
+}
+
+bool FlightRecorder::Dump(const char* fileName, const char* reason)
+{
+	int file = OpenDumpFile(fileName);
+
+	if (file < 0)
+	{
+		return false;
+	}
+
+	{
+		DumpWriter out(file);
+		out.Text("# ");
+		out.Text(reason);
+		out.Text("\n# keys is a bitset of the first 128 SDL scancodes, least significant bit first\n");
+		out.Text("frame,start_us,frame_us,input_us,update_us,render_us,actors,sprites,components,"
+			"draw_calls,texture_switches,allocs,alloc_bytes,keys\n");
+
+		Uint32 count = mCount;
+		Uint32 size = static_cast<Uint32>(mFrames.size());
+		Uint32 first = count > size ? count - size : 0;
+
+		for (Uint32 i = first; i < count; i++)
+		{
+			const Frame& frame = mFrames[i % size];
+			const Uint32 values[] = { frame.mFrame, frame.mStartUs, frame.mFrameUs, frame.mInputUs,
+				frame.mUpdateUs, frame.mRenderUs, frame.mActors, frame.mSprites, frame.mComponents,
+				frame.mDrawCalls, frame.mTextureSwitches, frame.mAllocs };
+
+			for (Uint32 value : values)
+			{
+				out.Number(value);
+				out.Char(',');
+			}
+
+			out.Number(frame.mAllocBytes);
+			out.Char(',');
+			out.Hex(frame.mKeys, KeyCount / 8);
+			out.Char('\n');
+		}
+	}
+
+	CloseDumpFile(file);
+	return true;
+}
+
+void FlightRecorder::OnFatalSignal(int signal)
+{
+	// (one dump, even if dumping is what crashed)
+	FlightRecorder* recorder = sActive;
+	sActive = nullptr;
+
+	if (recorder)
+	{
+		char reason[] = "fatal signal 00";
+		reason[13] = static_cast<char>('0' + signal / 10 % 10);
+		reason[14] = static_cast<char>('0' + signal % 10);
+		recorder->Dump("flight_crash.csv", reason);
+	}
+
+	// carry on dying the usual way
+	std::signal(signal, SIG_DFL);
+	std::raise(signal);
+}
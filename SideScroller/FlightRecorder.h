@@ -0,0 +1,68 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// always-on recorder of the last few seconds of frames
+// (phase times, counts, allocations and which keys were down), dumped
+// as CSV when a frame stalls past a threshold, or when the game dies
+// on a fatal signal, so there's data about what led up to it
+// (the crash dump only uses async-signal-safe calls, which is why the
+// CSV is all integers, in microseconds)
+class FlightRecorder
+{
+public:
+	FlightRecorder();
+	~FlightRecorder();
+
+	// keeps numFrames frames, dumping whenever one takes over stallMs
+	// (zero for crash dumps only)
+	bool Initialize(int numFrames, float stallMs);
+	void Shutdown();
+
+	// call once per frame, after it's finished
+	void AddFrame(const struct FrameStats& stats, const Uint8* keyState);
+
+	// writes every frame kept, oldest first
+	bool Dump(const char* fileName, const char* reason);
+
+private:
+	// keys are recorded for the first KeyCount scancodes (which covers
+	// letters, digits, space, the arrows and the function keys)
+	static const int KeyCount = 128;
+
+	struct Frame
+	{
+		Uint32 mFrame;
+		// since Initialize
+		Uint32 mStartUs;
+		Uint32 mFrameUs;
+		Uint32 mInputUs;
+		Uint32 mUpdateUs;
+		Uint32 mRenderUs;
+		Uint32 mActors;
+		Uint32 mSprites;
+		Uint32 mComponents;
+		Uint32 mDrawCalls;
+		Uint32 mTextureSwitches;
+		Uint32 mAllocs;
+		Uint64 mAllocBytes;
+		Uint8 mKeys[KeyCount / 8];
+	};
+
+	static void OnFatalSignal(int signal);
+
+	// the one recorder fatal signals dump
+	static FlightRecorder* sActive;
+
+	std::vector<Frame> mFrames;
+	// frames recorded so far (mFrames is a ring of the latest)
+	volatile Uint32 mCount;
+	Uint64 mStartCounter;
+
+	float mStallMs;
+	// stall dumps wait a second after Initialize (while things load),
+	// and then this many frames after each dump (so the frames it
+	// already covered are skipped)
+	int mFramesUntilArmed;
+	int mNumDumps;
+};
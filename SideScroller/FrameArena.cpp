@@ -0,0 +1,114 @@
+#include "FrameArena.h"
+#include <cstdlib>
+#include <cstdint>
+
+// (mLastOffset when the last allocation is gone)
+static const size_t NoOffset = static_cast<size_t>(-1);
+
+FrameArena::FrameArena(size_t capacity)
+	: mBlock(static_cast<char*>(std::malloc(capacity)))
+	, mCapacity(capacity)
+	, mTop(0)
+	, mLastOffset(NoOffset)
+	, mLastTop(0)
+	, mUsed(0)
+	, mFramePeak(0)
+	, mLastFramePeak(0)
+	, mPeak(0)
+	, mSpills(0)
+{
+}
+
+FrameArena::~FrameArena()
+{
+	Reset();
+	std::free(mBlock);
+}
+
+void* FrameArena::Allocate(size_t bytes, size_t align)
+{
+	// round the top up to the alignment (always a power of two)
+	uintptr_t base = reinterpret_cast<uintptr_t>(mBlock);
+	uintptr_t aligned = (base + mTop + align - 1) & ~static_cast<uintptr_t>(align - 1);
+	size_t offset = static_cast<size_t>(aligned - base);
+
+	void* ptr = nullptr;
+
+	if (offset + bytes <= mCapacity)
+	{
+		ptr = mBlock + offset;
+		mUsed += offset + bytes - mTop;
+		mLastOffset = offset;
+		mLastTop = mTop;
+		mTop = offset + bytes;
+	}
+	else
+	{
+		// (malloc is aligned enough for anything the game allocates)
+		ptr = std::malloc(bytes);
+		mOverflow.emplace_back(ptr);
+		mUsed += bytes;
+		mSpills++;
+	}
+
+	if (mUsed > mFramePeak)
+	{
+		mFramePeak = mUsed;
+	}
+
+	return ptr;
+}
+
+void FrameArena::Free(void* ptr, size_t bytes)
+{
+	char* p = static_cast<char*>(ptr);
+
+	if (p + bytes != mBlock + mTop || p < mBlock)
+	{
+		return;
+	}
+
+	// (anything under the last allocation only gives back its bytes,
+	// since its padding wasn't kept)
+	size_t top = (p == mBlock + mLastOffset) ? mLastTop : mTop - bytes;
+	mUsed -= mTop - top;
+	mTop = top;
+	mLastOffset = NoOffset;
+}
+
+void FrameArena::Reset()
+{
+	for (void* ptr : mOverflow)
+	{
+		std::free(ptr);
+	}
+
+	// if this frame spilled, grow so the same frame fits next time
+	if (!mOverflow.empty())
+	{
+		size_t capacity = mCapacity;
+
+		while (capacity < mFramePeak)
+		{
+			capacity *= 2;
+		}
+
+		std::free(mBlock);
+		mBlock = static_cast<char*>(std::malloc(capacity));
+		mCapacity = capacity;
+		mOverflow.clear();
+	}
+
+	mLastFramePeak = mFramePeak;
+
+	if (mFramePeak > mPeak)
+	{
+		mPeak = mFramePeak;
+	}
+
+	mTop = 0;
+	mLastOffset = NoOffset;
+	mLastTop = 0;
+	mUsed = 0;
+	mFramePeak = 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// a bump allocator for data that only lives for one frame
+// (Game resets it at the start of every frame, which frees everything
+// at once, so allocating is a pointer bump and freeing is free)
+// main thread only
+class FrameArena
+{
+public:
+	FrameArena(size_t capacity = 64 * 1024);
+	~FrameArena();
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// never fails: once the block is full, allocations spill to the
+	// heap until the next Reset, which grows the block to fit
+	void* Allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+	// gives memory back only if it is at the top of the block (so a
+	// container freed before anything else is allocated), otherwise
+	// does nothing until Reset. a growing vector allocates its new
+	// buffer before freeing the old one, so its old buffers always stay
+	// behind: grown from empty it uses about twice its final size
+	// (reserve up front when the size is known)
+	void Free(void* ptr, size_t bytes);
+
+	// frees everything allocated since the last reset
+	void Reset();
+
+	size_t GetCapacity() const { return mCapacity; }
+	// bytes allocated this frame (including spills)
+	size_t GetUsed() const { return mUsed; }
+	// most bytes in use at once last frame, and in any frame
+	size_t GetLastFramePeak() const { return mLastFramePeak; }
+	size_t GetPeak() const { return mPeak; }
+	// how many allocations didn't fit in the block, in total
+	int GetSpills() const { return mSpills; }
+
+private:
+	char* mBlock;
+	size_t mCapacity;
+	// offset of the next free byte in mBlock
+	size_t mTop;
+	// where the last allocation in the block starts, and mTop before
+	// it (so freeing it gives back its alignment padding too)
+	size_t mLastOffset;
+	size_t mLastTop;
+
+	size_t mUsed;
+	size_t mFramePeak;
+	size_t mLastFramePeak;
+	size_t mPeak;
+	int mSpills;
+	// heap allocations made this frame because the block was full
+	std::vector<void*> mOverflow;
+};
+
+// lets standard containers allocate from a FrameArena
+// (containers using this must not outlive the frame)
+template <typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+
+	FrameAllocator(FrameArena* arena)
+		: mArena(arena)
+	{
+	}
+
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other)
+		: mArena(other.GetArena())
+	{
+	}
+
+	T* allocate(size_t count)
+	{
+		return static_cast<T*>(mArena->Allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* ptr, size_t count)
+	{
+		mArena->Free(ptr, count * sizeof(T));
+	}
+
+	FrameArena* GetArena() const { return mArena; }
+
+private:
+	FrameArena* mArena;
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b)
+{
+	return a.GetArena() == b.GetArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b)
+{
+	return a.GetArena() != b.GetArena();
+}
+
+// a vector that only lives for this frame
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -0,0 +1,51 @@
+#pragma once
+#include <SDL.h>
+
+// what the last frames cost, gathered by Game for the HUD
+struct FrameStats
+{
+	// frames kept for the frame time graph
+	static const int HistorySize = 240;
+
+	FrameStats()
+		: mFrameMs()
+		, mNewest(HistorySize - 1)
+		, mInputMs(0.0f)
+		, mUpdateMs(0.0f)
+		, mRenderMs(0.0f)
+		, mActors(0)
+		, mSprites(0)
+		, mComponents(0)
+		, mDrawCalls(0)
+		, mTextureSwitches(0)
+		, mAllocs(0)
+		, mAllocBytes(0)
+	{
+	}
+
+	void AddFrameTime(float ms)
+	{
+		mNewest = (mNewest + 1) % HistorySize;
+		mFrameMs[mNewest] = ms;
+	}
+
+	// i frames ago (0 is the newest)
+	float GetFrameTime(int i) const { return mFrameMs[(mNewest - i + HistorySize) % HistorySize]; }
+
+	// ring of whole frame times, in milliseconds
+	float mFrameMs[HistorySize];
+	int mNewest;
+
+	// the last frame's phases
+	float mInputMs;
+	float mUpdateMs;
+	float mRenderMs;
+
+	int mActors;
+	int mSprites;
+	int mComponents;
+	int mDrawCalls;
+	int mTextureSwitches;
+	Uint64 mAllocs;
+	Uint64 mAllocBytes;
+};
@@ -1,16 +1,43 @@
 #include "Game.h"
 #include "SDL_image.h"
 #include <algorithm>
+#include <iterator>
 #include "Actor.h"
 #include "SpriteComponent.h"
 #include "Ship.h"
 #include "Asteroid.h"
+#include "Laser.h"
 #include "BGSpriteComponent.h"
+#include "Assets.h"
+#include "ThreadPool.h"
+#include "AnimationClip.h"
+#include "Benchmark.h"
+#include "SoftwareRasterizer.h"
+#include "RenderBackend.h"
+#include "AllocTracker.h"
+#include "Profiler.h"
+#include "Logger.h"
+#include "Random.h"
 
 Game::Game()
-	:mWindow(nullptr)
+	:mBenchmark(nullptr)
+	, mExitCode(0)
+	, mThreadPool(nullptr)
+	, mRasterizer(nullptr)
+	, mBackend(nullptr)
+	, mSceneTarget(nullptr)
+	, mWindow(nullptr)
 	, mRenderer(nullptr)
 	, mTicksCount(0)
+	, mGameTime(0.0f)
+	, mWorldSize(1024.0f, 768.0f)
+	, mStartCounter(0)
+	, mFirstFrameDrawn(false)
+	, mShowAllocOverlay(false)
+	, mShowHud(false)
+	, mPhaseCounts()
+	, mCountedFrames(0)
+	, mWorldHash(0)
 	, mIsRunning(true)
 	, mActors()
 	, mPendingActors()
@@ -18,16 +45,34 @@ Game::Game()
 {
 }
 
-bool Game::Initialize()
+bool Game::Initialize(const GameConfig& config)
 {
+	mConfig = config;
+	Logger::Start(mConfig.mLogFile, mConfig.mLogEcho);
+	Profiler::SetThreadName("Main");
+	mShowAllocOverlay = mConfig.mAllocOverlay;
+	mShowHud = mConfig.mHud;
+	mStartCounter = SDL_GetPerformanceCounter();
+
 	int sdlResult = SDL_Init(SDL_INIT_VIDEO);
 
 	if (sdlResult != 0)
 	{
-		SDL_Log("Unable to initialize SDL: %s", SDL_GetError());
+		LOG("Unable to initialize SDL: %s", SDL_GetError());
+		return false;
+	}
+
+	// benchmarks run headless, as fast as they can
+	bool benchmarking = !mConfig.mBenchmark.empty();
+
+	// and so do replays
+	if (!mConfig.mReplayFile.empty() && !mInput.BeginReplay(mConfig.mReplayFile))
+	{
 		return false;
 	}
 
+	bool headless = benchmarking || mInput.IsReplaying();
+
 	// create an sdl window
 	mWindow = SDL_CreateWindow(
 		"SDL Game",
@@ -35,34 +80,140 @@ bool Game::Initialize()
 		100,
 		1024,
 		768,
-		0
+		headless ? SDL_WINDOW_HIDDEN : 0
 	);
 
 	if (!mWindow)
 	{
-		SDL_Log("Failed to create window: %s", SDL_GetError());
+		LOG("Failed to create window: %s", SDL_GetError());
 		return false;
 	}
 
+	Uint32 rendererFlags = mConfig.mSoftwareRenderer
+		? SDL_RENDERER_SOFTWARE
+		: SDL_RENDERER_ACCELERATED | (headless ? 0 : SDL_RENDERER_PRESENTVSYNC);
+
 	mRenderer = SDL_CreateRenderer(
 		mWindow,
 		-1,
-		SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
+		rendererFlags
 	);
 
 	if (!mRenderer)
 	{
-		SDL_Log("Failed to create renderer: %s", SDL_GetError());
+		LOG("Failed to create renderer: %s", SDL_GetError());
 		return false;
 	}
 
+	mTextures.SetRenderer(mRenderer);
+	mTextures.SetBudget(mConfig.mTextureBudgetMB * 1024 * 1024);
+
 	if (IMG_Init(IMG_INIT_PNG) == 0)
 	{
-		SDL_Log("Unable to initialize SDL_Image: %s", SDL_GetError());
+		LOG("Unable to initialize SDL_Image: %s", SDL_GetError());
 		return false;
 	}
 
-	LoadData();
+	mThreadPool = new ThreadPool();
+
+	if (mConfig.mCpuRaster)
+	{
+		// the rasterizer samples textures from system memory
+		mTextures.SetKeepPixels(true);
+
+		mRasterizer = new SoftwareRasterizer();
+
+		if (!mRasterizer->Initialize(mRenderer, 1024, 768, mThreadPool))
+		{
+			return false;
+		}
+
+		if (mConfig.mBilinear)
+		{
+			mRasterizer->SetFilter(BlitKernels::EBilinear);
+		}
+	}
+
+	if (mRasterizer)
+	{
+		mBackend = mRasterizer;
+	}
+	else
+	{
+		mBackend = new SDLRenderBackend(mRenderer);
+	}
+
+	if (!mHud.Initialize(mRenderer))
+	{
+		LOG("Performance HUD unavailable");
+	}
+
+	if (mConfig.mFlightFrames > 0)
+	{
+		mFlightRecorder.Initialize(mConfig.mFlightFrames, mConfig.mStallDumpMs);
+	}
+
+	if (mConfig.mTelemetryFrames > 0)
+	{
+		mTelemetry.Initialize(TELEMETRY_NAME, mConfig.mTelemetryFrames);
+	}
+
+	if (mConfig.mPerfCounters)
+	{
+		mPerfCounters.Initialize();
+	}
+
+	if (mConfig.mDynamicResBudgetMs > 0.0f)
+	{
+		if (!InitDynamicResolution())
+		{
+			LOG("Dynamic resolution unavailable, rendering at full resolution");
+		}
+	}
+
+	// decode everything the last recorded session used up front,
+	// instead of on first use
+	if (!mConfig.mPreloadManifest.empty())
+	{
+		mTextures.Preload(mConfig.mPreloadManifest, *mThreadPool);
+	}
+
+	LoadRotationSheets();
+
+	if (benchmarking)
+	{
+		mBenchmark = new Benchmark(this, mConfig.mBenchmark, mConfig.mBenchmarkFrames, mConfig.mBenchmarkCount);
+		mBenchmark->SetScenario(mConfig.mScenario);
+		mBenchmark->SetRuns(mConfig.mBenchmarkRuns);
+		mBenchmark->SetCounters(&mPerfCounters);
+
+		if (!mBenchmark->LoadScene())
+		{
+			return false;
+		}
+	}
+	else
+	{
+		// the world is built from the random seed, so a recording
+		// keeps the one it was built with
+		if (mInput.IsReplaying())
+		{
+			Random::Seed(mInput.GetSeed());
+		}
+		else if (!mConfig.mRecordInputFile.empty())
+		{
+			unsigned int seed = static_cast<unsigned int>(SDL_GetPerformanceCounter());
+			Random::Seed(seed);
+			mInput.BeginRecord(mConfig.mRecordInputFile, seed);
+		}
+
+		LoadData();
+	}
+
+	if (!mConfig.mWorldHashFile.empty())
+	{
+		mWorldHashes.open(mConfig.mWorldHashFile);
+	}
 
 	mTicksCount = SDL_GetTicks();
 
@@ -71,21 +222,206 @@ bool Game::Initialize()
 
 void Game::RunLoop()
 {
+	if (!mConfig.mProfileFile.empty())
+	{
+		Profiler::StartCapture(mConfig.mProfileFrames, mConfig.mProfileFile);
+	}
+
 	while (mIsRunning)
 	{
-		ProcessInput();
-		UpdateGame();
-		GenerateOutput();
+		// everything from last frame's arena is dead now
+		mFrameArena.Reset();
+
+		// (reading the counters costs a system call each, when they're on)
+		Uint64 start = SDL_GetPerformanceCounter();
+		PerfCounters::Sample countsStart = mPerfCounters.Read();
+		bool hasInput = true;
+		{
+			AllocTracker::ScopeGuard scope(AllocTracker::EInput);
+			hasInput = ProcessInput();
+		}
+
+		if (!hasInput)
+		{
+			break;
+		}
+
+		Uint64 afterInput = SDL_GetPerformanceCounter();
+		PerfCounters::Sample countsInput = mPerfCounters.Read();
+		{
+			AllocTracker::ScopeGuard scope(AllocTracker::EUpdate);
+			UpdateGame();
+		}
+		Uint64 afterUpdate = SDL_GetPerformanceCounter();
+		PerfCounters::Sample countsUpdate = mPerfCounters.Read();
+		{
+			AllocTracker::ScopeGuard scope(AllocTracker::ERender);
+			GenerateOutput();
+		}
+		Uint64 afterOutput = SDL_GetPerformanceCounter();
+		PerfCounters::Sample countsOutput = mPerfCounters.Read();
+
+		PerfCounters::Sample phaseCounts[3] = {
+			PerfCounters::Difference(countsStart, countsInput),
+			PerfCounters::Difference(countsInput, countsUpdate),
+			PerfCounters::Difference(countsUpdate, countsOutput),
+		};
+		bool countsValid = phaseCounts[0].mValid && phaseCounts[1].mValid && phaseCounts[2].mValid;
+
+		// (first, so the allocation counts below are this frame's)
+		AllocTracker::EndFrame();
+
+		// for the HUD (drawn next frame, so it shows this one)
+		float toMs = 1000.0f / SDL_GetPerformanceFrequency();
+		mStats.AddFrameTime((afterOutput - start) * toMs);
+		mStats.mInputMs = (afterInput - start) * toMs;
+		mStats.mUpdateMs = (afterUpdate - afterInput) * toMs;
+		mStats.mRenderMs = (afterOutput - afterUpdate) * toMs;
+		mStats.mActors = static_cast<int>(mActors.size());
+		mStats.mSprites = static_cast<int>(mSprites.size());
+		mStats.mComponents = Component::GetCount();
+		mStats.mDrawCalls = mBackend->GetStats().mDrawCalls;
+		mStats.mTextureSwitches = mBackend->GetStats().mTextureSwitches;
+		AllocTracker::Counters allocs = AllocTracker::GetFrameTotal();
+		mStats.mAllocs = allocs.mAllocs;
+		mStats.mAllocBytes = allocs.mBytes;
+		mTelemetry.Publish(mStats);
+		mFlightRecorder.AddFrame(mStats, SDL_GetKeyboardState(nullptr));
+
+		Profiler::EndFrame();
+
+		if (mBenchmark)
+		{
+			mBenchmark->AddFrame(afterInput - start, afterUpdate - afterInput, afterOutput - afterUpdate,
+				countsValid ? phaseCounts : nullptr);
+
+			if (mBenchmark->IsDone())
+			{
+				mIsRunning = false;
+			}
+			else if (mBenchmark->NeedsReload())
+			{
+				ReloadBenchmarkScene();
+			}
+		}
+		else if (countsValid)
+		{
+			for (int phase = 0; phase < 3; phase++)
+			{
+				for (int i = 0; i < PerfCounters::NumCounters; i++)
+				{
+					mPhaseCounts[phase].mValues[i] += phaseCounts[phase].mValues[i];
+				}
+			}
+
+			mCountedFrames++;
+		}
 	}
 }
 
 void Game::Shutdown()
 {
+	if (mFirstFrameDrawn)
+	{
+		const TextureCache::Stats& stats = mTextures.GetStats();
+		LOG("Mid-game texture load stalls: %d", stats.mLoadStalls);
+		LOG("Textures resident: %d (%u KB), evictions: %d, reloads: %d",
+			stats.mResidentCount,
+			static_cast<unsigned>(stats.mResidentBytes / 1024),
+			stats.mEvictions,
+			stats.mReloads);
+	}
+
+	LOG("Frame arena: peak %u KB of %u KB, %d spills",
+		static_cast<unsigned>(mFrameArena.GetPeak() / 1024),
+		static_cast<unsigned>(mFrameArena.GetCapacity() / 1024),
+		mFrameArena.GetSpills());
+
+	if (!mConfig.mRecordManifest.empty())
+	{
+		mTextures.WriteManifest(mConfig.mRecordManifest);
+	}
+
+	// (a benchmark reports its own, next to its timings)
+	if (mCountedFrames > 0)
+	{
+		const char* phaseNames[] = { "input", "update", "output" };
+
+		for (int phase = 0; phase < 3; phase++)
+		{
+			const Uint64* counts = mPhaseCounts[phase].mValues;
+			double frames = static_cast<double>(mCountedFrames);
+
+			LOG("Counters %s per frame: %s %.0f, %s %.0f, %s %.0f, %s %.0f", phaseNames[phase],
+				mPerfCounters.GetName(0), counts[0] / frames, mPerfCounters.GetName(1), counts[1] / frames,
+				mPerfCounters.GetName(2), counts[2] / frames, mPerfCounters.GetName(3), counts[3] / frames);
+		}
+	}
+
+	if (mBenchmark)
+	{
+		mBenchmark->Report();
+
+		if (!mConfig.mBenchmarkJson.empty())
+		{
+			mBenchmark->WriteJson(mConfig.mBenchmarkJson);
+		}
+
+		if (!mConfig.mBenchmarkSaveBaseline.empty())
+		{
+			mBenchmark->WriteBaseline(mConfig.mBenchmarkSaveBaseline);
+		}
+
+		if (!mConfig.mBenchmarkBaseline.empty() &&
+			!mBenchmark->Compare(mConfig.mBenchmarkBaseline, mConfig.mBenchmarkThreshold))
+		{
+			mExitCode = 1;
+		}
+
+		delete mBenchmark;
+		mBenchmark = nullptr;
+	}
+
+	if (mSceneTarget)
+	{
+		LOG("Dynamic resolution: scale %.2f, %.2f ms smoothed render time, %d changes over %u frames",
+			mResolution.GetScale(), mResolution.GetSmoothedMs(), mResolution.GetNumChanges(), mResolution.GetFrameCount());
+
+		SDL_DestroyTexture(mSceneTarget);
+		mSceneTarget = nullptr;
+	}
+
 	UnloadData();
+	mHud.Shutdown();
+
+	if (mInput.IsReplaying() || mWorldHashes.is_open())
+	{
+		LOG("World hash after %u frames: %016llx", mInput.GetFrame(), static_cast<unsigned long long>(mWorldHash));
+	}
+
+	mInput.End();
+	mWorldHashes.close();
+	mTelemetry.Shutdown();
+	mFlightRecorder.Shutdown();
+	mPerfCounters.Shutdown();
+
+	if (mBackend != mRasterizer)
+	{
+		delete mBackend;
+	}
+
+	mBackend = nullptr;
+	delete mRasterizer;
+	mRasterizer = nullptr;
+	delete mThreadPool;
+	mThreadPool = nullptr;
 	IMG_Quit();
 	SDL_DestroyRenderer(mRenderer);
 	SDL_DestroyWindow(mWindow);
 	SDL_Quit();
+
+	// (last, so everything above is in the log)
+	Logger::Stop();
 }
 
 void Game::AddActor(Actor* actor)
@@ -113,13 +449,14 @@ void Game::RemoveActor(Actor* actor)
 		mPendingActors.pop_back();
 	}
 
-	// is it in actors?
-	iter = std::find(mActors.begin(), mActors.end(), actor);
+	// is it in actors? (searched from the back, where teardown deletes
+	// from and where the newest, shortest lived, actors are)
+	auto found = std::find(mActors.rbegin(), mActors.rend(), actor);
 
-	if (iter != mActors.end())
+	if (found != mActors.rend())
 	{
 		// swap to end and pop off
-		std::iter_swap(iter, mActors.end() - 1);
+		std::iter_swap(found, mActors.rbegin());
 		mActors.pop_back();
 	}
 }
@@ -130,15 +467,8 @@ void Game::AddSprite(SpriteComponent* sprite)
 	// (the first element with a higher draw order)
 	int myDrawOrder = sprite->GetDrawOrder();
 
-	auto iter = mSprites.begin();
-
-	for (; iter != mSprites.end(); ++iter)
-	{
-		if (myDrawOrder < (*iter)->GetDrawOrder())
-		{
-			break;
-		}
-	}
+	auto iter = std::upper_bound(mSprites.begin(), mSprites.end(), myDrawOrder,
+		[](int drawOrder, const SpriteComponent* other) { return drawOrder < other->GetDrawOrder(); });
 
 	// insert element before position of iterator
 	mSprites.insert(iter, sprite);
@@ -146,43 +476,120 @@ void Game::AddSprite(SpriteComponent* sprite)
 
 void Game::RemoveSprite(SpriteComponent* sprite)
 {
-	auto iter = std::find(mSprites.begin(), mSprites.end(), sprite);
-	mSprites.erase(iter);
+	// (from the back, like RemoveActor, so tearing down a big scene
+	// isn't quadratic)
+	auto iter = std::find(mSprites.rbegin(), mSprites.rend(), sprite);
+	mSprites.erase(std::next(iter).base());
+}
+
+Texture* Game::GetTexture(const AssetId& id)
+{
+	return mTextures.GetTexture(id);
 }
 
-SDL_Texture* Game::GetTexture(const std::string& fileName)
+const AnimationClip* Game::GetAnimClip(const std::vector<AssetId>& frames, float fps)
 {
-	SDL_Texture* tex = nullptr;
-	// is the texture already in the map?
-	auto iter = mTextures.find(fileName);
+	uint32_t key = AssetId::Hash("");
 
-	if (iter != mTextures.end())
+	for (auto& id : frames)
 	{
-		tex = iter->second;
+		key = AssetId::Combine(key, id.GetHash());
 	}
-	else
+
+	uint32_t fpsBits = 0;
+	SDL_memcpy(&fpsBits, &fps, sizeof(fpsBits));
+	key = AssetId::Combine(key, fpsBits);
+
+	auto range = mAnimClips.equal_range(key);
+
+	for (auto iter = range.first; iter != range.second; ++iter)
+	{
+		if (iter->second.mFrames == frames && iter->second.mFps == fps)
+		{
+			return iter->second.mClip;
+		}
+	}
+
+	AllocTracker::ScopeGuard scope(AllocTracker::EAssets);
+
+	// each frame is a whole texture, shown for 1/fps seconds
+	std::vector<AnimationClip::Frame> clipFrames;
+
+	for (auto& id : frames)
 	{
-		// load from file
-		SDL_Surface* surf = IMG_Load(fileName.c_str());
+		Texture* tex = GetTexture(id);
 
-		if (!surf)
+		if (tex)
 		{
-			SDL_Log("Failed to load texture file: %s", fileName.c_str());
-			return nullptr;
+			SDL_Rect region = { 0, 0, tex->GetWidth(), tex->GetHeight() };
+			clipFrames.emplace_back(AnimationClip::Frame{ tex, region, 1.0f / fps });
 		}
+	}
+
+	if (clipFrames.empty())
+	{
+		return nullptr;
+	}
+
+	AnimationClip* clip = new AnimationClip(clipFrames);
+	mAnimClips.emplace(key, CachedClip{ frames, fps, clip });
+
+	return clip;
+}
+
+// what mRotationSheets is keyed by
+static uint32_t GetSheetKey(const AssetId& id, const RotationSheet::Settings& settings)
+{
+	uint32_t resolutionBits = 0;
+	SDL_memcpy(&resolutionBits, &settings.mResolution, sizeof(resolutionBits));
+
+	uint32_t key = AssetId::Combine(id.GetHash(), static_cast<uint32_t>(settings.mSteps));
+	key = AssetId::Combine(key, resolutionBits);
+	return AssetId::Combine(key, static_cast<uint32_t>(settings.mFilter));
+}
+
+const RotationSheet* Game::GetRotationSheet(const AssetId& id, const RotationSheet::Settings& settings)
+{
+	auto range = mRotationSheets.equal_range(GetSheetKey(id, settings));
 
-		// create texture from surface
-		tex = SDL_CreateTextureFromSurface(mRenderer, surf);
-		SDL_FreeSurface(surf);
+	for (auto iter = range.first; iter != range.second; ++iter)
+	{
+		const CachedSheet& cached = iter->second;
 
-		if (!tex)
+		if (cached.mId == id && cached.mSettings.mSteps == settings.mSteps &&
+			cached.mSettings.mResolution == settings.mResolution && cached.mSettings.mFilter == settings.mFilter)
 		{
-			SDL_Log("Failed to convert surface to texture for %s", fileName.c_str());
-			return nullptr;
+			return cached.mSheet;
 		}
 	}
 
-	return tex;
+	return nullptr;
+}
+
+void Game::LoadRotationSheets()
+{
+	if (!mConfig.mRotationSheets || mRasterizer)
+	{
+		return;
+	}
+
+	BuildRotationSheet(Assets::Asteroid, Asteroid::GetSheetSettings());
+	BuildRotationSheet(Assets::Laser, Laser::GetSheetSettings());
+}
+
+void Game::BuildRotationSheet(const AssetId& id, const RotationSheet::Settings& settings)
+{
+	AllocTracker::ScopeGuard scope(AllocTracker::EAssets);
+	RotationSheet* sheet = new RotationSheet();
+
+	if (!sheet->Build(mTextures, id, settings))
+	{
+		delete sheet;
+		sheet = nullptr;
+	}
+
+	// (failures are kept too, as null, so sprites fall back to rotating)
+	mRotationSheets.emplace(GetSheetKey(id, settings), CachedSheet{ id, settings, sheet });
 }
 
 void Game::AddAsteroid(Asteroid* ast)
@@ -192,16 +599,18 @@ void Game::AddAsteroid(Asteroid* ast)
 
 void Game::RemoveAsteroid(Asteroid* ast)
 {
-	auto iter = std::find(mAsteroids.begin(), mAsteroids.end(), ast);
+	auto iter = std::find(mAsteroids.rbegin(), mAsteroids.rend(), ast);
 
-	if (iter != mAsteroids.end())
+	if (iter != mAsteroids.rend())
 	{
-		mAsteroids.erase(iter);
+		mAsteroids.erase(std::next(iter).base());
 	}
 }
 
-void Game::ProcessInput()
+bool Game::ProcessInput()
 {
+	PROFILE_ZONE("ProcessInput");
+
 	SDL_Event event;
 
 	// while there are still events in the queue
@@ -212,11 +621,37 @@ void Game::ProcessInput()
 		case SDL_QUIT:
 			mIsRunning = false;
 			break;
+		case SDL_KEYDOWN:
+			if (event.key.keysym.scancode == SDL_SCANCODE_F1 && !event.key.repeat)
+			{
+				mShowAllocOverlay = !mShowAllocOverlay;
+			}
+			else if (event.key.keysym.scancode == SDL_SCANCODE_F3 && !event.key.repeat)
+			{
+				mShowHud = !mShowHud;
+			}
+			else if (event.key.keysym.scancode == SDL_SCANCODE_F2 && !event.key.repeat)
+			{
+				Profiler::StartCapture(mConfig.mProfileFrames,
+					mConfig.mProfileFile.empty() ? "trace.json" : mConfig.mProfileFile);
+			}
+			break;
 		}
 	}
 
 	const Uint8* keyState = SDL_GetKeyboardState(NULL);
 
+	if (mInput.IsReplaying())
+	{
+		if (!mInput.NextFrame())
+		{
+			mIsRunning = false;
+			return false;
+		}
+
+		keyState = mInput.GetKeyState();
+	}
+
 	if (keyState[SDL_SCANCODE_ESCAPE])
 	{
 		mIsRunning = false;
@@ -231,13 +666,22 @@ void Game::ProcessInput()
 	}
 	
 	mUpdatingActors = false;
+
+	return true;
 }
 
 void Game::UpdateGame()
 {
 	// wait until 16ms has elapsed since last frame
-	while (!SDL_TICKS_PASSED(SDL_GetTicks(), mTicksCount + 16))
-		;
+	// (benchmarks don't wait, their frames are timed directly)
+	{
+		PROFILE_ZONE("FrameLimiter");
+
+		while (!mBenchmark && !mInput.IsReplaying() && !SDL_TICKS_PASSED(SDL_GetTicks(), mTicksCount + 16))
+			;
+	}
+
+	PROFILE_ZONE("UpdateGame");
 
 	// delta time is the difference in ticks from last frame
 	// (converted to seconds)
@@ -251,15 +695,44 @@ void Game::UpdateGame()
 
 	mTicksCount = SDL_GetTicks();
 
-	// update all actors
-	mUpdatingActors = true;
-	
-	for (auto actor : mActors)
+	if (mInput.IsReplaying())
+	{
+		deltaTime = mInput.GetDeltaTime();
+	}
+	else if (mBenchmark)
 	{
-		actor->Update(deltaTime);
+		// (a fixed step, so every run simulates the same thing however
+		// fast its frames are)
+		deltaTime = 1.0f / 60.0f;
+	}
+	else
+	{
+		// (nothing has pumped events since ProcessInput, so the keys
+		// are the ones the actors saw)
+		mInput.RecordFrame(SDL_GetKeyboardState(NULL), deltaTime);
 	}
 
-	mUpdatingActors = false;
+	mGameTime += deltaTime;
+
+	// update all actors
+	// (while capturing, a zone per component type inside this one
+	// shows how the time split between them)
+	{
+		PROFILE_ZONE("UpdateActors");
+		mUpdatingActors = true;
+	
+		for (auto actor : mActors)
+		{
+			actor->Update(deltaTime);
+		}
+
+		mUpdatingActors = false;
+
+		if (Profiler::IsCapturing())
+		{
+			Profiler::RecordTotals();
+		}
+	}
 
 	// move any pending actors to mActors
 	for (auto pending : mPendingActors)
@@ -270,7 +743,7 @@ void Game::UpdateGame()
 	mPendingActors.clear();
 
 	// add any dead actors to a temp vector
-	std::vector<Actor*> deadActors;
+	FrameVector<Actor*> deadActors(&mFrameArena);
 
 	for (auto actor : mActors)
 	{
@@ -285,27 +758,252 @@ void Game::UpdateGame()
 	{
 		delete actor;
 	}
+
+	if (mWorldHashes.is_open() || mInput.IsReplaying())
+	{
+		mWorldHash = HashWorld();
+
+		if (mWorldHashes.is_open())
+		{
+			mWorldHashes << std::hex << mWorldHash << std::dec << '\n';
+		}
+	}
+}
+
+Uint64 Game::HashWorld() const
+{
+	// FNV-1a over every actor's state, in update order
+	Uint64 hash = 14695981039346656037ull;
+
+	auto add = [&hash](const void* data, size_t size)
+	{
+		const Uint8* bytes = static_cast<const Uint8*>(data);
+
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+	};
+
+	size_t numActors = mActors.size();
+	add(&numActors, sizeof(numActors));
+
+	for (const Actor* actor : mActors)
+	{
+		Actor::State state = actor->GetState();
+		float values[] = { actor->GetPosition().x, actor->GetPosition().y, actor->GetRotation(), actor->GetScale() };
+		add(&state, sizeof(state));
+		add(values, sizeof(values));
+	}
+
+	return hash;
+}
+
+void Game::ReloadBenchmarkScene()
+{
+	// (between frames, so nothing is pending)
+	while (!mActors.empty())
+	{
+		delete mActors.back();
+	}
+
+	mWorldSize = Vector2(1024.0f, 768.0f);
+	mBenchmark->LoadScene();
+}
+
+bool Game::InitDynamicResolution()
+{
+	// the CPU rasterizer always fills its whole framebuffer, so
+	// drawing it smaller would only lose detail
+	if (mRasterizer || !SDL_RenderTargetSupported(mRenderer))
+	{
+		return false;
+	}
+
+	int width = 0;
+	int height = 0;
+	SDL_GetRendererOutputSize(mRenderer, &width, &height);
+
+	// filter the upscale (the hint is read when the texture is created)
+	const char* oldQuality = SDL_GetHint(SDL_HINT_RENDER_SCALE_QUALITY);
+	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+	mSceneTarget = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, oldQuality ? oldQuality : "nearest");
+
+	if (!mSceneTarget)
+	{
+		LOG("Failed to create scene target: %s", SDL_GetError());
+		return false;
+	}
+
+	SDL_SetTextureBlendMode(mSceneTarget, SDL_BLENDMODE_NONE);
+
+	mResolution.SetBudget(mConfig.mDynamicResBudgetMs);
+	mResolution.SetRange(0.5f, 1.0f);
+
+	return true;
 }
 
 void Game::GenerateOutput()
 {
+	PROFILE_ZONE("GenerateOutput");
+
+	mTextures.BeginFrame();
+
+	Uint64 renderStart = SDL_GetPerformanceCounter();
+
+	if (mSceneTarget)
+	{
+		// (setting a target resets the scale, so scale after)
+		SDL_SetRenderTarget(mRenderer, mSceneTarget);
+		SDL_RenderSetScale(mRenderer, mResolution.GetScale(), mResolution.GetScale());
+	}
+
 	// Set draw color to blue
 	SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 255);
 
 	// Clear back buffer
 	SDL_RenderClear(mRenderer);
 
-	// draw all sprite components
-	if (mSprites.size() > 0)
+	// record all sprite components, then draw what they recorded
+	RecordSprites();
+	{
+		PROFILE_ZONE("ExecuteCommands");
+		mBackend->Execute(mCommands);
+	}
+
+	if (mSceneTarget)
+	{
+		// stretch the part that was drawn to the window
+		int width = 0;
+		int height = 0;
+		SDL_QueryTexture(mSceneTarget, nullptr, nullptr, &width, &height);
+
+		SDL_Rect drawn;
+		drawn.x = 0;
+		drawn.y = 0;
+		drawn.w = static_cast<int>(width * mResolution.GetScale() + 0.5f);
+		drawn.h = static_cast<int>(height * mResolution.GetScale() + 0.5f);
+
+		SDL_SetRenderTarget(mRenderer, nullptr);
+		SDL_RenderCopy(mRenderer, mSceneTarget, &drawn, nullptr);
+
+		// the time to here is what the scale controls (present may
+		// wait on vsync, which would hide how much headroom there is)
+		float ms = (SDL_GetPerformanceCounter() - renderStart) * 1000.0f / SDL_GetPerformanceFrequency();
+		mResolution.AddFrame(ms);
+	}
+
+	// (on top of everything, at window resolution)
+	if (mShowAllocOverlay)
+	{
+		DrawAllocOverlay();
+	}
+
+	if (mShowHud)
+	{
+		mHud.Draw(mStats);
+	}
+
+	// Swap front buffer and back buffer
+	{
+		PROFILE_ZONE("RenderPresent");
+		SDL_RenderPresent(mRenderer);
+	}
+
+	if (!mFirstFrameDrawn)
+	{
+		mFirstFrameDrawn = true;
+		mTextures.MarkFirstFrame();
+
+		float ms = (SDL_GetPerformanceCounter() - mStartCounter) * 1000.0f / SDL_GetPerformanceFrequency();
+		LOG("Time to first frame: %.1f ms", ms);
+	}
+}
+
+void Game::RecordSprites()
+{
+	PROFILE_ZONE("RecordSprites");
+
+	// sprites per chunk, enough to be worth handing to another thread
+	const size_t chunkSize = 1024;
+	size_t numChunks = (mSprites.size() + chunkSize - 1) / chunkSize;
+
+	mCommands.Clear();
+
+	if (numChunks <= 1)
 	{
 		for (auto sprite : mSprites)
 		{
-			sprite->Draw(mRenderer);
+			sprite->Draw(mCommands);
 		}
+
+		return;
 	}
 
-	// Swap front buffer and back buffer
-	SDL_RenderPresent(mRenderer);
+	if (mChunkCommands.size() < numChunks)
+	{
+		mChunkCommands.resize(numChunks);
+	}
+
+	// each chunk records into its own buffer...
+	mThreadPool->ParallelFor(numChunks, [this, chunkSize](size_t chunk) {
+		RenderCommandBuffer& commands = mChunkCommands[chunk];
+		commands.Clear();
+
+		size_t end = std::min(mSprites.size(), (chunk + 1) * chunkSize);
+
+		for (size_t i = chunk * chunkSize; i < end; i++)
+		{
+			mSprites[i]->Draw(commands);
+		}
+	});
+
+	// ...and they're joined in chunk order, which keeps draw order
+	for (size_t chunk = 0; chunk < numChunks; chunk++)
+	{
+		mCommands.Append(mChunkCommands[chunk]);
+	}
+}
+
+void Game::DrawAllocOverlay()
+{
+	// one bar per scope along the bottom left, as long as last frame's
+	// allocation count (a pixel per allocation, in the scope's color),
+	// with a thin bar under it for bytes (a pixel per 64 bytes)
+	static const SDL_Color colors[AllocTracker::NumScopes] = {
+		{ 80, 160, 255, 255 }, // input, blue
+		{ 80, 255, 80, 255 }, // update, green
+		{ 255, 200, 40, 255 }, // render, yellow
+		{ 255, 80, 80, 255 }, // assets, red
+		{ 200, 200, 200, 255 }, // other, grey
+	};
+
+	const int maxWidth = 400;
+	int width = 0;
+	int height = 0;
+	SDL_GetRendererOutputSize(mRenderer, &width, &height);
+
+	SDL_Rect background = { 8, height - 8 - AllocTracker::NumScopes * 12, maxWidth + 8, AllocTracker::NumScopes * 12 };
+	SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 160);
+	SDL_RenderFillRect(mRenderer, &background);
+	SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_NONE);
+
+	for (int i = 0; i < AllocTracker::NumScopes; i++)
+	{
+		const AllocTracker::Counters& frame = AllocTracker::GetFrame(static_cast<AllocTracker::Scope>(i));
+		const SDL_Color& color = colors[i];
+		SDL_SetRenderDrawColor(mRenderer, color.r, color.g, color.b, color.a);
+
+		SDL_Rect allocs = { background.x + 4, background.y + 2 + i * 12, 0, 6 };
+		allocs.w = static_cast<int>(Math::Min<Uint64>(frame.mAllocs, maxWidth));
+		SDL_RenderFillRect(mRenderer, &allocs);
+
+		SDL_Rect bytes = { allocs.x, allocs.y + 7, 0, 2 };
+		bytes.w = static_cast<int>(Math::Min<Uint64>(frame.mBytes / 64, maxWidth));
+		SDL_RenderFillRect(mRenderer, &bytes);
+	}
 }
 
 void Game::LoadData()
@@ -322,21 +1020,18 @@ void Game::LoadData()
 	// create the far back background
 	BGSpriteComponent* bg = new BGSpriteComponent(temp);
 	bg->SetScreenSize(Vector2(1024.0f, 768.0f));
-	std::vector<SDL_Texture*> bgTexs = {
-		GetTexture("Assets/Farback01.png"),
-		GetTexture("Assets/Farback02.png")
-	};
-	bg->SetBGTextures(bgTexs);
+	bg->SetBGTextures({
+		Assets::Farback01,
+		Assets::Farback02
+	});
 	bg->SetScrollSpeed(-100.0f);
 
 	// create the closer background
 	bg = new BGSpriteComponent(temp, 50);
 	bg->SetScreenSize(Vector2(1024.0f, 768.0f));
-	bgTexs = {
-		GetTexture("Assets/Stars.png"),
-		GetTexture("Assets/Stars.png")
-	};
-	bg->SetBGTextures(bgTexs);
+	bg->SetBGTextures({
+		Assets::Stars
+	});
 	bg->SetScrollSpeed(-200.0f);
 
 	// create asteroids
@@ -353,20 +1048,27 @@ void Game::UnloadData()
 	// delete actors
 	if (mActors.size() > 0)
 	{
-		while (!mActors.back())
+		while (!mActors.empty())
 		{
 			delete mActors.back();
 		}
 	}
 
-	// destory textures
-	if (mTextures.size() > 0)
+	// delete animation clips
+	for (auto& clip : mAnimClips)
 	{
-		for (auto i : mTextures)
-		{
-			SDL_DestroyTexture(i.second);
-		}
+		delete clip.second.mClip;
+	}
 
-		mTextures.clear();
+	mAnimClips.clear();
+
+	for (auto& sheet : mRotationSheets)
+	{
+		delete sheet.second.mSheet;
 	}
+
+	mRotationSheets.clear();
+
+	// destory textures
+	mTextures.Clear();
 }
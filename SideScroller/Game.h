@@ -2,8 +2,21 @@
 #include <SDL.h>
 
 #include <unordered_map>
-#include <string>
 #include <vector>
+#include "TextureCache.h"
+#include "GameConfig.h"
+#include "RotationSheet.h"
+#include "ResolutionScaler.h"
+#include "RenderCommandBuffer.h"
+#include "FrameArena.h"
+#include "Math.h"
+#include "FrameStats.h"
+#include "PerfHud.h"
+#include "Telemetry.h"
+#include "FlightRecorder.h"
+#include "PerfCounters.h"
+#include "InputRecording.h"
+#include <fstream>
 
 #undef main
 
@@ -11,7 +24,7 @@ class Game
 {
 public:
 	Game();
-	bool Initialize();
+	bool Initialize(const GameConfig& config = GameConfig());
 	void RunLoop();
 	void Shutdown();
 
@@ -21,7 +34,34 @@ public:
 	void AddSprite(class SpriteComponent* sprite);
 	void RemoveSprite(class SpriteComponent* sprite);
 
-	SDL_Texture* GetTexture(const std::string& fileName);
+	class Texture* GetTexture(const AssetId& id);
+
+	// the clip playing these frames at fps, built on first request
+	// and then shared by everyone who asks for the same one
+	const class AnimationClip* GetAnimClip(const std::vector<AssetId>& frames, float fps);
+
+	// the texture pre-rotated to settings.mSteps angles, shared like
+	// clips (null unless -rotation-sheets is on, and never with the
+	// CPU rasterizer, which rotates for free). sheets are built at load
+	// time by LoadRotationSheets, so this is a lookup only, and null
+	// for anything not built there
+	const RotationSheet* GetRotationSheet(const AssetId& id, const RotationSheet::Settings& settings = RotationSheet::Settings());
+
+	// where things live, and wrap around (the window's size, unless a
+	// benchmark scenario makes it bigger)
+	const Vector2& GetWorldSize() const { return mWorldSize; }
+	void SetWorldSize(const Vector2& size) { mWorldSize = size; }
+
+	// what main returns (non-zero when a benchmark regressed)
+	int GetExitCode() const { return mExitCode; }
+
+	// seconds of game time since the game started
+	float GetTime() const { return mGameTime; }
+	const TextureCache::Stats& GetTextureStats() const { return mTextures.GetStats(); }
+	// scratch memory that is freed at the start of the next frame
+	FrameArena& GetFrameArena() { return mFrameArena; }
+	// the dynamic resolution controller (null unless -dynamic-res is on)
+	const ResolutionScaler* GetResolutionScaler() const { return mSceneTarget ? &mResolution : nullptr; }
 
 	// game specific (add/remove asteroid)
 	void AddAsteroid(class Asteroid* ast);
@@ -29,14 +69,50 @@ public:
 	std::vector<class Asteroid*>& GetAsteroids() { return mAsteroids; }
 
 private:
-	void ProcessInput();
+	// returns false when a replay has run out (so the frame stops
+	// there, without an update the recording never had)
+	bool ProcessInput();
 	void UpdateGame();
 	void GenerateOutput();
+	// fills mCommands from every sprite, in parallel chunks
+	void RecordSprites();
+	// last frame's allocations per scope, as bars (toggled with F1)
+	void DrawAllocOverlay();
+	// sets up mSceneTarget, returns false if the renderer can't
+	bool InitDynamicResolution();
+	// the state of every actor, hashed
+	Uint64 HashWorld() const;
+	// deletes every actor and has the benchmark build its scene again
+	void ReloadBenchmarkScene();
 	void LoadData();
+	// builds every rotation sheet the game's actors use, up front
+	// (building one mid-game would stall a frame on decode and render)
+	void LoadRotationSheets();
+	void BuildRotationSheet(const AssetId& id, const RotationSheet::Settings& settings);
 	void UnloadData();
 
-	// map of textures loaded
-	std::unordered_map<std::string, SDL_Texture*> mTextures;
+	// textures loaded
+	TextureCache mTextures;
+
+	// animation clips, keyed by a hash of their frames and rate (which
+	// two clips can share, so each keeps what it was built from)
+	struct CachedClip
+	{
+		std::vector<AssetId> mFrames;
+		float mFps;
+		class AnimationClip* mClip;
+	};
+	std::unordered_multimap<uint32_t, CachedClip> mAnimClips;
+	// rotation sheets, keyed by a hash of their texture and settings
+	// and checked like clips (failed builds are kept as null so they
+	// aren't retried)
+	struct CachedSheet
+	{
+		AssetId mId;
+		RotationSheet::Settings mSettings;
+		RotationSheet* mSheet;
+	};
+	std::unordered_multimap<uint32_t, CachedSheet> mRotationSheets;
 
 	std::vector<class Actor*> mActors;
 	std::vector<class Actor*> mPendingActors;
@@ -44,9 +120,67 @@ private:
 	// all the sprite components drawn
 	std::vector<class SpriteComponent*> mSprites;
 
+	GameConfig mConfig;
+
+	// set when running a benchmark instead of the game
+	class Benchmark* mBenchmark;
+	int mExitCode;
+
+	// worker threads shared by anything that splits up its work
+	class ThreadPool* mThreadPool;
+
+	class SoftwareRasterizer* mRasterizer;
+
+	// executes the frame's draw commands (the rasterizer, if there
+	// is one, otherwise an SDLRenderBackend owned by the game)
+	class RenderBackend* mBackend;
+	// the whole frame's commands, in draw order
+	RenderCommandBuffer mCommands;
+	// per-frame temporaries (reset at the top of every frame)
+	FrameArena mFrameArena;
+
+	// one per chunk of sprites when recording in parallel
+	// (kept between frames, like mCommands, so they stop allocating)
+	std::vector<RenderCommandBuffer> mChunkCommands;
+
+	// with dynamic resolution, the scene is drawn into the top left
+	// of this (at mResolution's scale) and then stretched to the window
+	SDL_Texture* mSceneTarget;
+	ResolutionScaler mResolution;
+
 	SDL_Window* mWindow;
 	SDL_Renderer* mRenderer;
 	Uint32 mTicksCount;
+	float mGameTime;
+	Vector2 mWorldSize;
+
+	// performance counter when Initialize started
+	// (used to report the time to first frame)
+	Uint64 mStartCounter;
+	bool mFirstFrameDrawn;
+
+	bool mShowAllocOverlay;
+
+	// last frames' costs and counts, and the HUD showing them (F3)
+	FrameStats mStats;
+	PerfHud mHud;
+	bool mShowHud;
+	// mStats again, for readers outside the game (see -telemetry)
+	Telemetry mTelemetry;
+	// the last few seconds of mStats, dumped on a stall or crash
+	FlightRecorder mFlightRecorder;
+	// CPU counters read around each phase (-perf-counters), and their
+	// totals per phase (input, update, output) when not benchmarking
+	PerfCounters mPerfCounters;
+	PerfCounters::Sample mPhaseCounts[3];
+	Uint64 mCountedFrames;
+
+	// input being recorded (-record-input) or replayed (-replay)
+	InputRecording mInput;
+	// a line per frame with its world hash, so runs (before and after
+	// a change, say) can be checked for doing the same thing
+	std::ofstream mWorldHashes;
+	Uint64 mWorldHash;
 
 	bool mIsRunning;
 	bool mUpdatingActors;
@@ -0,0 +1,211 @@
+#include "GameConfig.h"
+#include <SDL.h>
+#include <cstdlib>
+#include <cstring>
+
+GameConfig::GameConfig()
+	: mSoftwareRenderer(false)
+	, mCpuRaster(false)
+	, mBilinear(false)
+	, mRotationSheets(false)
+	, mDynamicResBudgetMs(0.0f)
+	, mAllocOverlay(false)
+	, mHud(false)
+	, mPerfCounters(false)
+	, mTelemetryFrames(0)
+	, mFlightFrames(600)
+	, mStallDumpMs(100.0f)
+	, mLogEcho(true)
+	, mProfileFrames(120)
+	, mBenchmarkFrames(600)
+	, mBenchmarkCount(100000)
+	, mBenchmarkRuns(1)
+	, mBenchmarkThreshold(3.0f)
+	, mTextureBudgetMB(0)
+{
+}
+
+bool GameConfig::Parse(int argc, char** argv)
+{
+	bool stallDumpSet = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		// the value following this argument (if any)
+		const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+		if (std::strcmp(arg, "-record-manifest") == 0 && value)
+		{
+			mRecordManifest = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-preload") == 0 && value)
+		{
+			mPreloadManifest = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-software") == 0)
+		{
+			mSoftwareRenderer = true;
+		}
+		else if (std::strcmp(arg, "-cpu-raster") == 0)
+		{
+			mCpuRaster = true;
+		}
+		else if (std::strcmp(arg, "-bilinear") == 0)
+		{
+			mBilinear = true;
+		}
+		else if (std::strcmp(arg, "-rotation-sheets") == 0)
+		{
+			mRotationSheets = true;
+		}
+		else if (std::strcmp(arg, "-dynamic-res") == 0 && value)
+		{
+			mDynamicResBudgetMs = static_cast<float>(std::atof(value));
+			i++;
+		}
+		else if (std::strcmp(arg, "-alloc-overlay") == 0)
+		{
+			mAllocOverlay = true;
+		}
+		else if (std::strcmp(arg, "-hud") == 0)
+		{
+			mHud = true;
+		}
+		else if (std::strcmp(arg, "-perf-counters") == 0)
+		{
+			mPerfCounters = true;
+		}
+		else if (std::strcmp(arg, "-telemetry") == 0)
+		{
+			mTelemetryFrames = 4096;
+		}
+		else if (std::strcmp(arg, "-telemetry-frames") == 0 && value)
+		{
+			mTelemetryFrames = std::atoi(value);
+			i++;
+		}
+		else if (std::strcmp(arg, "-flight-frames") == 0 && value)
+		{
+			mFlightFrames = std::atoi(value);
+			i++;
+		}
+		else if (std::strcmp(arg, "-stall-ms") == 0 && value)
+		{
+			mStallDumpMs = static_cast<float>(std::atof(value));
+			stallDumpSet = true;
+			i++;
+		}
+		else if (std::strcmp(arg, "-record-input") == 0 && value)
+		{
+			mRecordInputFile = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-replay") == 0 && value)
+		{
+			mReplayFile = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-world-hashes") == 0 && value)
+		{
+			mWorldHashFile = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-log") == 0 && value)
+		{
+			mLogFile = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-log-quiet") == 0)
+		{
+			mLogEcho = false;
+		}
+		else if (std::strcmp(arg, "-profile") == 0 && value)
+		{
+			mProfileFile = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-profile-frames") == 0 && value)
+		{
+			mProfileFrames = std::atoi(value);
+			i++;
+		}
+		else if (std::strcmp(arg, "-scenario") == 0 && value)
+		{
+			mScenario = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-bench") == 0 && value)
+		{
+			mBenchmark = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-bench-frames") == 0 && value)
+		{
+			mBenchmarkFrames = std::atoi(value);
+			i++;
+		}
+		else if (std::strcmp(arg, "-bench-json") == 0 && value)
+		{
+			mBenchmarkJson = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-bench-count") == 0 && value)
+		{
+			mBenchmarkCount = std::atoi(value);
+			i++;
+		}
+		else if (std::strcmp(arg, "-bench-runs") == 0 && value)
+		{
+			mBenchmarkRuns = std::atoi(value);
+			i++;
+		}
+		else if (std::strcmp(arg, "-bench-save-baseline") == 0 && value)
+		{
+			mBenchmarkSaveBaseline = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-bench-baseline") == 0 && value)
+		{
+			mBenchmarkBaseline = value;
+			i++;
+		}
+		else if (std::strcmp(arg, "-bench-threshold") == 0 && value)
+		{
+			mBenchmarkThreshold = static_cast<float>(std::atof(value));
+			i++;
+		}
+		else if (std::strcmp(arg, "-texture-budget") == 0 && value)
+		{
+			mTextureBudgetMB = static_cast<size_t>(std::strtoul(value, nullptr, 10));
+			i++;
+		}
+		else
+		{
+			SDL_Log("Unknown or incomplete argument: %s", arg);
+			return false;
+		}
+	}
+
+	// (a scenario on its own means run it)
+	if (!mScenario.empty() && mBenchmark.empty())
+	{
+		mBenchmark = "scenario";
+	}
+
+	if (!stallDumpSet && (!mBenchmark.empty() || !mReplayFile.empty()))
+	{
+		mStallDumpMs = 0.0f;
+	}
+
+	// (Benchmark::MinBaselineRuns, fewer can never show a regression)
+	if ((!mBenchmarkBaseline.empty() || !mBenchmarkSaveBaseline.empty()) && mBenchmarkRuns < 4)
+	{
+		SDL_Log("Benchmark baselines need -bench-runs 4 or more");
+		return false;
+	}
+
+	return true;
+}
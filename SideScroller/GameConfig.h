@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// startup options, filled in from the command line
+struct GameConfig
+{
+	GameConfig();
+
+	// returns false (after logging why) on a bad argument
+	bool Parse(int argc, char** argv);
+
+	// write every asset requested this session to this file on shutdown
+	std::string mRecordManifest;
+	// decode every asset listed in this file before the first frame
+	std::string mPreloadManifest;
+	// use SDL's software renderer (what headless hosts without a GPU get)
+	bool mSoftwareRenderer;
+	// draw sprites with the multithreaded SoftwareRasterizer
+	bool mCpuRaster;
+	// filter the rasterizer's sprites bilinearly instead of nearest
+	bool mBilinear;
+	// draw rotating sprites from pre-rotated sheets
+	bool mRotationSheets;
+	// render the scene offscreen at a resolution that drops (down to
+	// half) to keep render time under this many milliseconds, then
+	// upscale it to the window (zero for always full resolution)
+	float mDynamicResBudgetMs;
+	// start with the allocation overlay showing (F1 toggles it)
+	bool mAllocOverlay;
+	// start with the performance HUD showing (F3 toggles it)
+	bool mHud;
+	// count instructions, cycles, cache and branch misses per frame
+	// phase (Linux only, see PerfCounters)
+	bool mPerfCounters;
+	// publish frame stats into a shared memory ring this many frames
+	// long, for the TelemetryReader tool (zero for off)
+	int mTelemetryFrames;
+	// keep this many frames for flight recorder dumps (zero for off)
+	int mFlightFrames;
+	// dump them when a frame takes longer than this (zero for only on
+	// a crash, which is the default for benchmarks and replays, whose
+	// frames are slow on purpose and shouldn't pay for dumps)
+	float mStallDumpMs;
+	// record every frame's input to this file, or replay one (headless,
+	// as fast as it goes) from this one
+	std::string mRecordInputFile;
+	std::string mReplayFile;
+	// write each frame's world hash here
+	std::string mWorldHashFile;
+	// also write the log here, in binary, for the LogDecoder tool
+	std::string mLogFile;
+	// echo the log to the console (off with -log-quiet)
+	bool mLogEcho;
+	// write a Chrome trace of the first mProfileFrames frames here
+	// (F2 captures one at any time, to this file or trace.json)
+	std::string mProfileFile;
+	int mProfileFrames;
+	// run this benchmark headless instead of the game (empty for none)
+	std::string mBenchmark;
+	int mBenchmarkFrames;
+	// the world the "scenario" benchmark builds: a preset (1k, 10k,
+	// 100k, 1m), a file, or inline "key=value,..." (see Scenario)
+	std::string mScenario;
+	// also write the benchmark's results to this file as JSON
+	std::string mBenchmarkJson;
+	// how many objects the benchmark spawns
+	int mBenchmarkCount;
+	// measure the benchmark this many times, rebuilding the scene each
+	// time (comparisons treat each run as one sample, so they need 4 or
+	// more, and 5 or so to be confident)
+	int mBenchmarkRuns;
+	// write every frame's phase times here, or compare against the
+	// ones written here and exit non-zero if a phase got more than
+	// mBenchmarkThreshold percent slower (see Benchmark::Compare)
+	std::string mBenchmarkSaveBaseline;
+	std::string mBenchmarkBaseline;
+	float mBenchmarkThreshold;
+	// resident texture memory cap in megabytes (zero for none)
+	size_t mTextureBudgetMB;
+};
@@ -8,6 +8,8 @@ public:
 	// lower update order to update first
 	InputComponent(class Actor* owner);
 
+	const char* GetName() const override { return "InputComponent"; }
+
 	void ProcessInput(const uint8_t* keyState) override;
 
 	// getters / setters
@@ -0,0 +1,186 @@
+#include "InputRecording.h"
+#include <cstring>
+#include "Logger.h"
+
+static const Uint32 Magic = 0x52495353;
+static const Uint32 Version = 1;
+
+InputRecording::InputRecording()
+	: mPos(0)
+	, mSeed(0)
+	, mFrame(0)
+	, mKeys()
+	, mDeltaTime(0.0f)
+{
+}
+
+InputRecording::~InputRecording()
+{
+	End();
+}
+
+bool InputRecording::BeginRecord(const std::string& fileName, unsigned int seed)
+{
+	mFile.open(fileName, std::ios::binary);
+
+	if (!mFile.is_open())
+	{
+		LOG("Failed to open input recording: %s", fileName.c_str());
+		return false;
+	}
+
+	mFile.write(reinterpret_cast<const char*>(&Magic), 4);
+	mFile.write(reinterpret_cast<const char*>(&Version), 4);
+	mFile.write(reinterpret_cast<const char*>(&seed), 4);
+
+	mSeed = seed;
+	mFrame = 0;
+	std::memset(mKeys, 0, sizeof(mKeys));
+	// (so the first frame always writes its delta)
+	mDeltaTime = -1.0f;
+
+	LOG("Recording input to %s (seed %u)", fileName.c_str(), seed);
+	return true;
+}
+
+bool InputRecording::BeginReplay(const std::string& fileName)
+{
+	std::ifstream file(fileName, std::ios::binary);
+
+	if (!file.is_open())
+	{
+		LOG("Failed to open input recording: %s", fileName.c_str());
+		return false;
+	}
+
+	mReplay.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	Uint32 magic = 0;
+	Uint32 version = 0;
+
+	if (mReplay.size() < 12)
+	{
+		mReplay.clear();
+	}
+	else
+	{
+		std::memcpy(&magic, &mReplay[0], 4);
+		std::memcpy(&version, &mReplay[4], 4);
+		std::memcpy(&mSeed, &mReplay[8], 4);
+	}
+
+	if (magic != Magic || version != Version)
+	{
+		LOG("%s isn't an input recording", fileName.c_str());
+		mReplay.clear();
+		return false;
+	}
+
+	mPos = 12;
+	mFrame = 0;
+	std::memset(mKeys, 0, sizeof(mKeys));
+	mDeltaTime = 0.0f;
+
+	LOG("Replaying input from %s (seed %u)", fileName.c_str(), mSeed);
+	return true;
+}
+
+void InputRecording::End()
+{
+	if (mFile.is_open())
+	{
+		LOG("Recorded %u frames of input", mFrame);
+		mFile.close();
+	}
+
+	mReplay.clear();
+}
+
+void InputRecording::RecordFrame(const Uint8* keyState, float deltaTime)
+{
+	if (!mFile.is_open())
+	{
+		return;
+	}
+
+	// the keys that went up or down since last frame
+	Uint8 changed[NumKeys];
+	int numChanged = 0;
+
+	for (int key = 0; key < NumKeys; key++)
+	{
+		Uint8 down = keyState[key] ? 1 : 0;
+
+		if (down != mKeys[key])
+		{
+			mKeys[key] = down;
+			changed[numChanged++] = static_cast<Uint8>(key);
+		}
+	}
+
+	Uint8 flags = 0;
+	flags |= (deltaTime != mDeltaTime) ? EDeltaTime : 0;
+	flags |= (numChanged > 0) ? EKeys : 0;
+	mFile.put(static_cast<char>(flags));
+
+	if (flags & EDeltaTime)
+	{
+		mFile.write(reinterpret_cast<const char*>(&deltaTime), 4);
+		mDeltaTime = deltaTime;
+	}
+
+	// (all 256 changing is written as a count of zero)
+	if (flags & EKeys)
+	{
+		mFile.put(static_cast<char>(numChanged));
+		mFile.write(reinterpret_cast<const char*>(changed), numChanged);
+	}
+
+	mFrame++;
+}
+
+bool InputRecording::NextFrame()
+{
+	if (mPos >= mReplay.size())
+	{
+		return false;
+	}
+
+	Uint8 flags = mReplay[mPos++];
+
+	if (flags & EDeltaTime)
+	{
+		if (mPos + 4 > mReplay.size())
+		{
+			return false;
+		}
+
+		std::memcpy(&mDeltaTime, &mReplay[mPos], 4);
+		mPos += 4;
+	}
+
+	if (flags & EKeys)
+	{
+		if (mPos >= mReplay.size())
+		{
+			return false;
+		}
+
+		int numChanged = mReplay[mPos++];
+		numChanged = numChanged == 0 ? NumKeys : numChanged;
+
+		if (mPos + numChanged > mReplay.size())
+		{
+			return false;
+		}
+
+		for (int i = 0; i < numChanged; i++)
+		{
+			Uint8 key = mReplay[mPos++];
+			mKeys[key] = !mKeys[key];
+		}
+	}
+
+	mFrame++;
+	return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <SDL.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// records the keyboard state and delta time of every frame, plus the
+// random seed the world was built with, so a run can be replayed
+// exactly (headless, as fast as it goes) for profiling
+// (the file is delta-encoded: a flag byte per frame, then only what
+// changed since the frame before)
+class InputRecording
+{
+public:
+	InputRecording();
+	~InputRecording();
+
+	// starts writing to fileName
+	bool BeginRecord(const std::string& fileName, unsigned int seed);
+	// loads fileName to replay
+	bool BeginReplay(const std::string& fileName);
+	void End();
+
+	bool IsRecording() const { return mFile.is_open(); }
+	bool IsReplaying() const { return !mReplay.empty(); }
+	unsigned int GetSeed() const { return mSeed; }
+
+	// recording: adds a frame
+	void RecordFrame(const Uint8* keyState, float deltaTime);
+
+	// replaying: moves to the next frame, false once there are none
+	bool NextFrame();
+	// the current frame's keys (indexed by scancode, like
+	// SDL_GetKeyboardState) and delta time
+	const Uint8* GetKeyState() const { return mKeys; }
+	float GetDeltaTime() const { return mDeltaTime; }
+	Uint32 GetFrame() const { return mFrame; }
+
+private:
+	// keys past this aren't recorded (SDL's keyboard scancodes all are)
+	static const int NumKeys = 256;
+
+	enum Flags
+	{
+		EDeltaTime = 1,
+		EKeys = 2
+	};
+
+	std::ofstream mFile;
+	// the whole file being replayed, and how far through it we are
+	std::vector<Uint8> mReplay;
+	size_t mPos;
+
+	unsigned int mSeed;
+	Uint32 mFrame;
+	// as of the last frame recorded or replayed
+	Uint8 mKeys[SDL_NUM_SCANCODES];
+	float mDeltaTime;
+};
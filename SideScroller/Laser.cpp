@@ -4,6 +4,8 @@
 #include "Game.h"
 #include "CircleComponent.h"
 #include "Asteroid.h"
+#include "Assets.h"
+#include "Profiler.h"
 
 Laser::Laser(Game* game)
 	: Actor(game)
@@ -11,7 +13,9 @@ Laser::Laser(Game* game)
 {
 	// create sprite component
 	SpriteComponent* sc = new SpriteComponent(this);
-	sc->SetTexture(game->GetTexture("Assets/Laser.png"));
+	sc->SetTexture(game->GetTexture(Assets::Laser));
+
+	sc->SetRotationSheet(game->GetRotationSheet(Assets::Laser, GetSheetSettings()));
 
 	// create a move component, and set a forward speed
 	MoveComponent* mc = new MoveComponent(this);
@@ -22,6 +26,16 @@ Laser::Laser(Game* game)
 	mCircle->SetRadius(11.0f);
 }
 
+RotationSheet::Settings Laser::GetSheetSettings()
+{
+	// the laser is tiny and gone in a second, so fewer, unfiltered
+	// angles are enough
+	RotationSheet::Settings sheet;
+	sheet.mSteps = 32;
+	sheet.mFilter = BlitKernels::ENearest;
+	return sheet;
+}
+
 void Laser::UpdateActor(float deltaTime)
 {
 	// if we run out of time, laser is dead
@@ -34,6 +48,8 @@ void Laser::UpdateActor(float deltaTime)
 	else
 	{
 		// do we intersect with an asteroid?
+		PROFILE_ZONE("Collision");
+
 		for (auto ast : GetGame()->GetAsteroids())
 		{
 			if (Intersect(*mCircle, *(ast->GetCircle())))
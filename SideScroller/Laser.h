@@ -1,11 +1,15 @@
 #pragma once
 #include "Actor.h"
+#include "RotationSheet.h"
 
 class Laser : public Actor
 {
 public:
 	Laser(class Game* game);
 
+	// the rotation sheet lasers draw from (Game builds it at load time)
+	static RotationSheet::Settings GetSheetSettings();
+
 	void UpdateActor(float deltaTime) override;
 
 private:
@@ -0,0 +1,153 @@
+#include "LogFormat.h"
+#include <cstdio>
+#include <cstring>
+
+// one decoded argument
+struct LogArg
+{
+	char mTag;
+	int64_t mInt;
+	uint64_t mUInt;
+	double mDouble;
+	std::string mString;
+};
+
+// reads the next argument, false when there are none left
+static bool ReadArg(const uint8_t*& args, const uint8_t* end, LogArg& arg)
+{
+	if (args >= end)
+	{
+		return false;
+	}
+
+	arg.mTag = static_cast<char>(*args++);
+
+	if (arg.mTag == 's')
+	{
+		uint16_t length = 0;
+
+		if (end - args < 2)
+		{
+			return false;
+		}
+
+		std::memcpy(&length, args, 2);
+		args += 2;
+
+		if (end - args < length)
+		{
+			return false;
+		}
+
+		arg.mString.assign(reinterpret_cast<const char*>(args), length);
+		args += length;
+		return true;
+	}
+
+	if (end - args < 8)
+	{
+		return false;
+	}
+
+	// (every other tag is eight bytes)
+	std::memcpy(&arg.mInt, args, 8);
+	std::memcpy(&arg.mUInt, args, 8);
+	std::memcpy(&arg.mDouble, args, 8);
+	args += 8;
+
+	return arg.mTag == 'i' || arg.mTag == 'u' || arg.mTag == 'd' || arg.mTag == 'p';
+}
+
+bool LogFormat::Render(const char* format, const uint8_t* args, size_t size, std::string& out)
+{
+	const uint8_t* end = args + size;
+	bool matched = true;
+	char buffer[512];
+
+	out.clear();
+
+	for (const char* c = format; *c; c++)
+	{
+		if (*c != '%')
+		{
+			out += *c;
+			continue;
+		}
+
+		if (c[1] == '%')
+		{
+			out += '%';
+			c++;
+			continue;
+		}
+
+		// flags, width and precision are kept, the length is replaced
+		// with whatever fits the stored argument
+		std::string spec = "%";
+		c++;
+
+		while (*c && std::strchr("-+ #0123456789.", *c))
+		{
+			spec += *c++;
+		}
+
+		while (*c && std::strchr("hljztL", *c))
+		{
+			c++;
+		}
+
+		if (!*c)
+		{
+			break;
+		}
+
+		char conversion = *c;
+		LogArg arg;
+
+		if (!ReadArg(args, end, arg))
+		{
+			out += "<missing>";
+			matched = false;
+			continue;
+		}
+
+		buffer[0] = '\0';
+
+		if (std::strchr("di", conversion) && (arg.mTag == 'i' || arg.mTag == 'u'))
+		{
+			std::snprintf(buffer, sizeof(buffer), (spec + "lld").c_str(), static_cast<long long>(arg.mInt));
+		}
+		else if (std::strchr("uxXoc", conversion) && (arg.mTag == 'i' || arg.mTag == 'u'))
+		{
+			if (conversion == 'c')
+			{
+				std::snprintf(buffer, sizeof(buffer), (spec + "c").c_str(), static_cast<int>(arg.mInt));
+			}
+			else
+			{
+				std::snprintf(buffer, sizeof(buffer), (spec + "ll" + conversion).c_str(), static_cast<unsigned long long>(arg.mUInt));
+			}
+		}
+		else if (std::strchr("fFeEgGaA", conversion) && arg.mTag == 'd')
+		{
+			std::snprintf(buffer, sizeof(buffer), (spec + conversion).c_str(), arg.mDouble);
+		}
+		else if (conversion == 's' && arg.mTag == 's')
+		{
+			std::snprintf(buffer, sizeof(buffer), (spec + "s").c_str(), arg.mString.c_str());
+		}
+		else if (conversion == 'p' && arg.mTag == 'p')
+		{
+			std::snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(arg.mUInt));
+		}
+		else
+		{
+			std::snprintf(buffer, sizeof(buffer), "<?>");
+			matched = false;
+		}
+
+		out += buffer;
+	}
+
+	return matched;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// layout of the binary log the Logger writes
+// (also built into the LogDecoder tool, so no SDL types here)
+//
+// the file starts with Magic, Version and the performance counter
+// frequency (u32, u32, u64), then entries, each a type byte followed by
+//   EFormat: u16 id, u32 line, str file, str format
+//   ERecord: u16 thread, then the record as the thread wrote it
+//   EDropped: u16 thread, u32 how many records didn't fit its ring
+// where str is a u16 length and that many bytes (no terminator)
+//
+// a record is u16 size (all of it, these fields included), u16 format
+// id, u64 performance counter, then per argument a tag and its value
+//   'i' int64, 'u' uint64, 'd' double, 'p' pointer as uint64, 's' str
+struct LogFormat
+{
+	static const uint32_t Magic = 0x474c5353;
+	static const uint32_t Version = 1;
+
+	enum Entry
+	{
+		EFormat = 'F',
+		ERecord = 'R',
+		EDropped = 'D'
+	};
+
+	static const size_t RecordHeaderSize = 12;
+
+	// renders a record's arguments through its printf style format
+	// (arguments that don't fit the format show up as <?> rather than
+	// being misread; returns false if any didn't)
+	static bool Render(const char* format, const uint8_t* args, size_t size, std::string& out);
+};
@@ -0,0 +1,313 @@
+#include "Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// one thread's records, written by that thread and read by the drain
+// thread (head and tail count bytes forever, wrapping in the buffer)
+struct ThreadLog
+{
+	static const uint32_t Capacity = 1 << 16;
+
+	ThreadLog(uint16_t thread)
+		: mData(Capacity)
+		, mHead(0)
+		, mTail(0)
+		, mDropped(0)
+		, mThread(thread)
+	{
+	}
+
+	std::vector<uint8_t> mData;
+	std::atomic<uint32_t> mHead;
+	std::atomic<uint32_t> mTail;
+	// records that didn't fit, since the drain last looked
+	std::atomic<uint32_t> mDropped;
+	uint16_t mThread;
+};
+
+// a LOG site
+struct FormatSite
+{
+	const char* mFile;
+	int mLine;
+	const char* mFormat;
+};
+
+// a drained record, waiting to be put in order
+struct PendingRecord
+{
+	Uint64 mTicks;
+	uint16_t mThread;
+	// into sPending
+	size_t mOffset;
+	size_t mSize;
+};
+
+// every thread's log (the lock is only taken when a thread logs for
+// the first time, and by the drain thread)
+static std::mutex sLogsMutex;
+static std::vector<std::unique_ptr<ThreadLog>> sLogs;
+static thread_local ThreadLog* sThreadLog = nullptr;
+
+// (a deque, so sites stay put as more are added)
+static std::mutex sFormatsMutex;
+static std::deque<FormatSite> sFormats;
+
+// the drain thread's state
+static std::thread sThread;
+static std::mutex sWakeMutex;
+static std::condition_variable sWakeCV;
+static bool sQuit = false;
+static bool sEcho = true;
+static std::ofstream sFile;
+static size_t sFormatsWritten = 0;
+static std::vector<uint8_t> sPending;
+static std::vector<PendingRecord> sOrder;
+static std::string sLine;
+
+static ThreadLog* GetThreadLog()
+{
+	if (!sThreadLog)
+	{
+		std::lock_guard<std::mutex> lock(sLogsMutex);
+		sLogs.emplace_back(new ThreadLog(static_cast<uint16_t>(sLogs.size())));
+		sThreadLog = sLogs.back().get();
+	}
+
+	return sThreadLog;
+}
+
+template <typename T>
+static void WriteValue(T value)
+{
+	sFile.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void WriteString(const char* s)
+{
+	uint16_t length = static_cast<uint16_t>(std::strlen(s));
+	WriteValue(length);
+	sFile.write(s, length);
+}
+
+bool Logger::Start(const std::string& fileName, bool echo)
+{
+	if (sThread.joinable())
+	{
+		return true;
+	}
+
+	sEcho = echo;
+	sQuit = false;
+
+	if (!fileName.empty())
+	{
+		sFile.open(fileName, std::ios::binary);
+
+		if (!sFile.is_open())
+		{
+			SDL_Log("Failed to open log file: %s", fileName.c_str());
+			return false;
+		}
+
+		WriteValue(LogFormat::Magic);
+		WriteValue(LogFormat::Version);
+		WriteValue(SDL_GetPerformanceFrequency());
+	}
+
+	sThread = std::thread(&Logger::DrainLoop);
+	return true;
+}
+
+void Logger::Stop()
+{
+	if (!sThread.joinable())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sWakeMutex);
+		sQuit = true;
+	}
+
+	sWakeCV.notify_one();
+	sThread.join();
+
+	if (sFile.is_open())
+	{
+		sFile.close();
+	}
+}
+
+uint16_t Logger::RegisterFormat(const char* file, int line, const char* format)
+{
+	std::lock_guard<std::mutex> lock(sFormatsMutex);
+
+	// (just the file's name, not the path it was built from)
+	const char* name = file;
+
+	for (const char* c = file; *c; c++)
+	{
+		if (*c == '/' || *c == '\\')
+		{
+			name = c + 1;
+		}
+	}
+
+	sFormats.push_back({ name, line, format });
+
+	return static_cast<uint16_t>(sFormats.size() - 1);
+}
+
+void Logger::Push(const uint8_t* record, size_t size)
+{
+	ThreadLog* log = GetThreadLog();
+	uint32_t head = log->mHead.load(std::memory_order_relaxed);
+	uint32_t tail = log->mTail.load(std::memory_order_acquire);
+
+	// never wait for the drain, drop instead
+	if (ThreadLog::Capacity - (head - tail) < size)
+	{
+		log->mDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	uint32_t start = head & (ThreadLog::Capacity - 1);
+	size_t first = std::min<size_t>(size, ThreadLog::Capacity - start);
+	std::memcpy(&log->mData[start], record, first);
+	std::memcpy(&log->mData[0], record + first, size - first);
+
+	log->mHead.store(head + static_cast<uint32_t>(size), std::memory_order_release);
+}
+
+void Logger::DrainLoop()
+{
+	std::unique_lock<std::mutex> lock(sWakeMutex);
+
+	while (!sQuit)
+	{
+		// (often enough that a crash loses little, rarely enough to be
+		// nearly free)
+		sWakeCV.wait_for(lock, std::chrono::milliseconds(10));
+
+		lock.unlock();
+		Drain();
+		lock.lock();
+	}
+
+	lock.unlock();
+	Drain();
+}
+
+void Logger::Drain()
+{
+	sPending.clear();
+	sOrder.clear();
+
+	// copy out every thread's new records, freeing their rings
+	{
+		std::lock_guard<std::mutex> lock(sLogsMutex);
+
+		for (auto& log : sLogs)
+		{
+			uint32_t dropped = log->mDropped.exchange(0, std::memory_order_relaxed);
+
+			if (dropped > 0 && sFile.is_open())
+			{
+				sFile.put(LogFormat::EDropped);
+				WriteValue(log->mThread);
+				WriteValue(dropped);
+			}
+
+			if (dropped > 0 && sEcho)
+			{
+				SDL_Log("(%u log records dropped on thread %u)", dropped, log->mThread);
+			}
+
+			uint32_t head = log->mHead.load(std::memory_order_acquire);
+			uint32_t tail = log->mTail.load(std::memory_order_relaxed);
+
+			while (tail != head)
+			{
+				uint8_t header[LogFormat::RecordHeaderSize];
+
+				for (size_t i = 0; i < LogFormat::RecordHeaderSize; i++)
+				{
+					header[i] = log->mData[(tail + i) & (ThreadLog::Capacity - 1)];
+				}
+
+				PendingRecord pending;
+				uint16_t size = 0;
+				std::memcpy(&size, header, 2);
+				std::memcpy(&pending.mTicks, header + 4, 8);
+				pending.mThread = log->mThread;
+				pending.mOffset = sPending.size();
+				pending.mSize = size;
+
+				for (uint32_t i = 0; i < size; i++)
+				{
+					sPending.push_back(log->mData[(tail + i) & (ThreadLog::Capacity - 1)]);
+				}
+
+				sOrder.push_back(pending);
+				tail += size;
+			}
+
+			log->mTail.store(tail, std::memory_order_release);
+		}
+	}
+
+	if (sOrder.empty())
+	{
+		return;
+	}
+
+	// interleave the threads by time
+	std::stable_sort(sOrder.begin(), sOrder.end(),
+		[](const PendingRecord& a, const PendingRecord& b) { return a.mTicks < b.mTicks; });
+
+	std::lock_guard<std::mutex> lock(sFormatsMutex);
+
+	for (const PendingRecord& pending : sOrder)
+	{
+		const uint8_t* record = &sPending[pending.mOffset];
+		uint16_t format = 0;
+		std::memcpy(&format, record + 2, 2);
+
+		if (sFile.is_open())
+		{
+			// sites go in the file before their first record
+			for (; sFormatsWritten < sFormats.size(); sFormatsWritten++)
+			{
+				const FormatSite& site = sFormats[sFormatsWritten];
+				sFile.put(LogFormat::EFormat);
+				WriteValue(static_cast<uint16_t>(sFormatsWritten));
+				WriteValue(static_cast<uint32_t>(site.mLine));
+				WriteString(site.mFile);
+				WriteString(site.mFormat);
+			}
+
+			sFile.put(LogFormat::ERecord);
+			WriteValue(pending.mThread);
+			sFile.write(reinterpret_cast<const char*>(record), pending.mSize);
+		}
+
+		if (sEcho)
+		{
+			LogFormat::Render(sFormats[format].mFormat, record + LogFormat::RecordHeaderSize,
+				pending.mSize - LogFormat::RecordHeaderSize, sLine);
+			SDL_Log("%s", sLine.c_str());
+		}
+	}
+
+	sFile.flush();
+}
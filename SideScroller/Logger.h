@@ -0,0 +1,135 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "LogFormat.h"
+
+// asynchronous binary logger
+// (LOG("format", args...) takes the same formats as SDL_Log, but the
+// calling thread only copies the site's format id and the raw
+// arguments into its own ring buffer, with no locks; a background
+// thread drains the rings into a compact binary file, for the
+// LogDecoder tool, and echoes each line to the console, so nothing is
+// formatted or written on the game's threads)
+class Logger
+{
+public:
+	// starts draining, into fileName if it isn't empty
+	// (anything logged before this waits in the rings)
+	static bool Start(const std::string& fileName, bool echo);
+	// drains whatever is left, then stops
+	static void Stop();
+
+	// once per LOG site, the id is what goes in each record
+	static uint16_t RegisterFormat(const char* file, int line, const char* format);
+
+	template <typename... Args>
+	static void Write(uint16_t format, const Args&... args)
+	{
+		uint8_t record[MaxRecordSize];
+		size_t size = LogFormat::RecordHeaderSize;
+
+		// (one Put per argument, in order)
+		int expand[] = { 0, (Put(record, size, args), 0)... };
+		(void)expand;
+
+		Uint64 ticks = SDL_GetPerformanceCounter();
+		uint16_t size16 = static_cast<uint16_t>(size);
+		std::memcpy(record, &size16, 2);
+		std::memcpy(record + 2, &format, 2);
+		std::memcpy(record + 4, &ticks, 8);
+
+		Push(record, size);
+	}
+
+private:
+	// records are built on the stack, so arguments past this are cut
+	static const size_t MaxRecordSize = 512;
+
+	static void Push(const uint8_t* record, size_t size);
+	static void DrainLoop();
+	static void Drain();
+
+	static void PutTagged(uint8_t* record, size_t& size, char tag, const void* value)
+	{
+		if (size + 9 <= MaxRecordSize)
+		{
+			record[size] = static_cast<uint8_t>(tag);
+			std::memcpy(record + size + 1, value, 8);
+			size += 9;
+		}
+	}
+
+	// (every integer is widened to 64 bits)
+	template <typename T>
+	static typename std::enable_if<std::is_integral<T>::value>::type Put(uint8_t* record, size_t& size, T value)
+	{
+		if (std::is_signed<T>::value)
+		{
+			int64_t wide = static_cast<int64_t>(value);
+			PutTagged(record, size, 'i', &wide);
+		}
+		else
+		{
+			uint64_t wide = static_cast<uint64_t>(value);
+			PutTagged(record, size, 'u', &wide);
+		}
+	}
+
+	template <typename T>
+	static typename std::enable_if<std::is_enum<T>::value>::type Put(uint8_t* record, size_t& size, T value)
+	{
+		int64_t wide = static_cast<int64_t>(value);
+		PutTagged(record, size, 'i', &wide);
+	}
+
+	template <typename T>
+	static typename std::enable_if<std::is_floating_point<T>::value>::type Put(uint8_t* record, size_t& size, T value)
+	{
+		double wide = static_cast<double>(value);
+		PutTagged(record, size, 'd', &wide);
+	}
+
+	template <typename T>
+	static void Put(uint8_t* record, size_t& size, const T* value)
+	{
+		uint64_t address = reinterpret_cast<uintptr_t>(value);
+		PutTagged(record, size, 'p', &address);
+	}
+
+	// strings are copied (cut to fit the record)
+	static void Put(uint8_t* record, size_t& size, const char* value)
+	{
+		if (size + 3 > MaxRecordSize)
+		{
+			return;
+		}
+
+		size_t length = value ? std::strlen(value) : 0;
+		length = length < MaxRecordSize - size - 3 ? length : MaxRecordSize - size - 3;
+		uint16_t length16 = static_cast<uint16_t>(length);
+
+		record[size] = 's';
+		std::memcpy(record + size + 1, &length16, 2);
+		if (length > 0)
+		{
+			std::memcpy(record + size + 3, value, length);
+		}
+
+		size += 3 + length;
+	}
+
+	static void Put(uint8_t* record, size_t& size, const std::string& value)
+	{
+		Put(record, size, value.c_str());
+	}
+};
+
+#define LOG(format, ...) \
+	do \
+	{ \
+		static const uint16_t logFormat = Logger::RegisterFormat(__FILE__, __LINE__, format); \
+		Logger::Write(logFormat, ##__VA_ARGS__); \
+	} while (0)
@@ -4,12 +4,27 @@
 #include <iostream>
 
 #include "Game.h"
+#include "GameConfig.h"
+#include "Benchmark.h"
 
-int main()
+int main(int argc, char** argv)
 {
+	GameConfig config;
+
+	if (!config.Parse(argc, argv))
+	{
+		return 1;
+	}
+
+	// kernel checks don't need a window
+	if (config.mBenchmark == "blit")
+	{
+		return Benchmark::RunBlitKernels(config.mBenchmarkCount);
+	}
+
 	Game game;
 
-	bool success = game.Initialize();
+	bool success = game.Initialize(config);
 
 	if (success)
 	{
@@ -18,5 +33,5 @@ int main()
 
 	game.Shutdown();
 
-	return 0;
-}
\ No newline at end of file
+	return game.GetExitCode();
+}
@@ -100,6 +100,23 @@ namespace Math
 	{
 		return fmod(numer, denom);
 	}
+
+	inline float Floor(float value)
+	{
+		return floorf(value);
+	}
+
+	inline float Ceil(float value)
+	{
+		return ceilf(value);
+	}
+
+	// integer division that rounds toward negative infinity
+	inline int FloorDiv(int numer, int denom)
+	{
+		int quot = numer / denom;
+		return (numer % denom != 0 && (numer < 0) != (denom < 0)) ? quot - 1 : quot;
+	}
 }
 
 // 2D Vector
@@ -1,5 +1,6 @@
 #include "MoveComponent.h"
 #include "Actor.h"
+#include "Game.h"
 
 MoveComponent::MoveComponent(Actor* owner, int updateOrder)
 	: Component(owner, updateOrder)
@@ -23,11 +24,13 @@ void MoveComponent::Update(float deltaTime)
 		pos += mOwner->GetForward() * mForwardSpeed * deltaTime;
 
 		// (screen wrapping code only for asteroids)
-		if (pos.x < 0.0f) { pos.x = 1022.0f; }
-		else if (pos.x > 1024.0f) { pos.x = 2.0f; }
+		const Vector2& world = mOwner->GetGame()->GetWorldSize();
 
-		if (pos.y < 0.0f) { pos.y = 766.0f; }
-		else if (pos.y > 768.0f) { pos.y = 2.0f; }	
+		if (pos.x < 0.0f) { pos.x = world.x - 2.0f; }
+		else if (pos.x > world.x) { pos.x = 2.0f; }
+
+		if (pos.y < 0.0f) { pos.y = world.y - 2.0f; }
+		else if (pos.y > world.y) { pos.y = 2.0f; }
 
 		mOwner->SetPosition(pos);
 	}
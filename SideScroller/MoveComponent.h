@@ -7,6 +7,8 @@ public:
 	// lower update order to update first
 	MoveComponent(class Actor* owner, int updateOrder = 10);
 
+	const char* GetName() const override { return "MoveComponent"; }
+
 	void Update(float deltaTime) override;
 
 	float GetAngularSpeed() const { return mAngularSpeed; }
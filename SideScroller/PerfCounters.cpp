@@ -0,0 +1,205 @@
+#include "PerfCounters.h"
+#include "Logger.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+static const char* sHardwareNames[PerfCounters::NumCounters] = { "instructions", "cycles", "cache-misses", "branch-misses" };
+static const char* sSoftwareNames[PerfCounters::NumCounters] = { "task-clock-ns", "page-faults", "context-switches", "cpu-migrations" };
+
+PerfCounters::PerfCounters()
+	: mHardware(false)
+{
+	for (int& fd : mFds)
+	{
+		fd = -1;
+	}
+}
+
+PerfCounters::~PerfCounters()
+{
+	Shutdown();
+}
+
+const char* PerfCounters::GetName(int counter) const
+{
+	return mHardware ? sHardwareNames[counter] : sSoftwareNames[counter];
+}
+
+PerfCounters::Sample PerfCounters::Difference(const Sample& before, const Sample& after)
+{
+	Sample difference = {};
+	difference.mValid = before.mValid && after.mValid;
+
+	if (!difference.mValid)
+	{
+		return difference;
+	}
+
+	// (scaled counts are estimates, so they can step back a little)
+	for (int i = 0; i < NumCounters; i++)
+	{
+		difference.mValues[i] = after.mValues[i] > before.mValues[i] ? after.mValues[i] - before.mValues[i] : 0;
+	}
+
+	return difference;
+}
+
+#ifdef __linux__
+
+bool PerfCounters::Initialize()
+{
+	const Uint32 hardwareTypes[NumCounters] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE };
+	const Uint64 hardwareConfigs[NumCounters] = {
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_CACHE_MISSES,
+		PERF_COUNT_HW_BRANCH_MISSES,
+	};
+
+	// (user space only, which is all perf_event_paranoid 2 allows)
+	if (Open(hardwareTypes, hardwareConfigs, true))
+	{
+		mHardware = true;
+		return true;
+	}
+
+	int hardwareError = errno;
+
+	const Uint32 softwareTypes[NumCounters] = { PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE };
+	const Uint64 softwareConfigs[NumCounters] = {
+		PERF_COUNT_SW_TASK_CLOCK,
+		PERF_COUNT_SW_PAGE_FAULTS,
+		PERF_COUNT_SW_CONTEXT_SWITCHES,
+		PERF_COUNT_SW_CPU_MIGRATIONS,
+	};
+
+	// (these happen in the kernel, so they can't exclude it)
+	if (Open(softwareTypes, softwareConfigs, false))
+	{
+		LOG("Hardware counters unavailable (%s), using software counters", std::strerror(hardwareError));
+		return true;
+	}
+
+	LOG("perf_event_open unavailable (%s), no counters", std::strerror(errno));
+	return false;
+}
+
+bool PerfCounters::Open(const Uint32 types[], const Uint64 configs[], bool userOnly)
+{
+	Shutdown();
+
+	for (int i = 0; i < NumCounters; i++)
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = types[i];
+		attr.config = configs[i];
+		// (with how long the group was enabled and actually counting,
+		// which differ when there are more events than counters)
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		// (the leader starts the whole group, below)
+		attr.disabled = i == 0;
+		attr.exclude_kernel = userOnly;
+		attr.exclude_hv = userOnly;
+
+		// this thread, on any CPU
+		mFds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, mFds[0], 0));
+
+		if (mFds[i] < 0)
+		{
+			int error = errno;
+			Shutdown();
+			errno = error;
+			return false;
+		}
+	}
+
+	ioctl(mFds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(mFds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	return true;
+}
+
+void PerfCounters::Shutdown()
+{
+	for (int& fd : mFds)
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+			fd = -1;
+		}
+	}
+
+	mHardware = false;
+}
+
+PerfCounters::Sample PerfCounters::Read() const
+{
+	Sample sample = {};
+
+	if (!IsOpen())
+	{
+		return sample;
+	}
+
+	// the number of counters, the time enabled and running, then each
+	// one's value
+	Uint64 values[3 + NumCounters];
+
+	if (read(mFds[0], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)))
+	{
+		return sample;
+	}
+
+	Uint64 enabled = values[1];
+	Uint64 running = values[2];
+
+	// (never scheduled, so there's nothing to scale)
+	if (running == 0)
+	{
+		return sample;
+	}
+
+	double scale = running < enabled ? static_cast<double>(enabled) / running : 1.0;
+
+	for (int i = 0; i < NumCounters; i++)
+	{
+		sample.mValues[i] = static_cast<Uint64>(values[3 + i] * scale);
+	}
+
+	sample.mValid = true;
+	return sample;
+}
+
+#else
+
+bool PerfCounters::Initialize()
+{
+	LOG("Performance counters are only available on Linux");
+	return false;
+}
+
+bool PerfCounters::Open(const Uint32[], const Uint64[], bool)
+{
+	return false;
+}
+
+void PerfCounters::Shutdown()
+{
+}
+
+PerfCounters::Sample PerfCounters::Read() const
+{
+	Sample sample = {};
+	return sample;
+}
+
+#endif
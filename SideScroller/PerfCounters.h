@@ -0,0 +1,47 @@
+#pragma once
+#include <SDL.h>
+
+// CPU event counters for the calling thread, read from Linux's
+// perf_event_open: instructions, cycles, cache misses and branch
+// misses, or the kernel's software counters where the hardware ones
+// aren't allowed (most containers and VMs). elsewhere there are none.
+// (the thread pool's workers aren't counted)
+class PerfCounters
+{
+public:
+	static const int NumCounters = 4;
+
+	struct Sample
+	{
+		Uint64 mValues[NumCounters];
+		// (false when the counters couldn't be read, mValues are zeros)
+		bool mValid;
+	};
+
+	PerfCounters();
+	~PerfCounters();
+
+	// opens the hardware counters, falling back to software ones,
+	// returns false if neither can be
+	bool Initialize();
+	void Shutdown();
+
+	bool IsOpen() const { return mFds[0] >= 0; }
+	bool IsHardware() const { return mHardware; }
+	// what mValues[counter] counts
+	const char* GetName(int counter) const;
+
+	// every counter's running total, scaled up for any time the kernel
+	// had the group switched out (invalid when closed or unread)
+	Sample Read() const;
+	// invalid unless both are
+	static Sample Difference(const Sample& before, const Sample& after);
+
+private:
+	// opens the counters as a group (so they're read together with one
+	// call), returns false and leaves everything closed if any fails
+	bool Open(const Uint32 types[], const Uint64 configs[], bool userOnly);
+
+	int mFds[NumCounters];
+	bool mHardware;
+};
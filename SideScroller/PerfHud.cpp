@@ -0,0 +1,282 @@
+#include "PerfHud.h"
+#include <cstdio>
+#include <vector>
+#include "Logger.h"
+
+// a 5x7 bitmap font, one byte per row (bit 4 is the leftmost pixel)
+// lowercase letters are drawn as uppercase, anything missing as a space
+struct Glyph
+{
+	char mChar;
+	Uint8 mRows[7];
+};
+
+static const Glyph sFont[] = {
+	{ '0', { 0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e } },
+	{ '1', { 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e } },
+	{ '2', { 0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f } },
+	{ '3', { 0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e } },
+	{ '4', { 0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02 } },
+	{ '5', { 0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e } },
+	{ '6', { 0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e } },
+	{ '7', { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+	{ '8', { 0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e } },
+	{ '9', { 0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c } },
+	{ 'A', { 0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 } },
+	{ 'B', { 0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e } },
+	{ 'C', { 0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e } },
+	{ 'D', { 0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c } },
+	{ 'E', { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f } },
+	{ 'F', { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10 } },
+	{ 'G', { 0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f } },
+	{ 'H', { 0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 } },
+	{ 'I', { 0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e } },
+	{ 'J', { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c } },
+	{ 'K', { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } },
+	{ 'L', { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f } },
+	{ 'M', { 0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+	{ 'N', { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 } },
+	{ 'O', { 0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e } },
+	{ 'P', { 0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10 } },
+	{ 'Q', { 0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d } },
+	{ 'R', { 0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11 } },
+	{ 'S', { 0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e } },
+	{ 'T', { 0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+	{ 'U', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e } },
+	{ 'V', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04 } },
+	{ 'W', { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a } },
+	{ 'X', { 0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11 } },
+	{ 'Y', { 0x11, 0x11, 0x11, 0x0a, 0x04, 0x04, 0x04 } },
+	{ 'Z', { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f } },
+	{ '.', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c } },
+	{ ',', { 0x00, 0x00, 0x00, 0x00, 0x0c, 0x04, 0x08 } },
+	{ ':', { 0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x0c, 0x00 } },
+	{ '/', { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 } },
+	{ '%', { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 } },
+	{ '-', { 0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00 } },
+	{ '=', { 0x00, 0x00, 0x1f, 0x00, 0x1f, 0x00, 0x00 } },
+	{ '(', { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 } },
+	{ ')', { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 } },
+};
+
+// where the HUD sits, and how big its parts are
+static const int PanelX = 8;
+static const int PanelY = 8;
+static const int PanelW = 496;
+static const int GraphH = 64;
+// pixels per millisecond, for the graph and the phase bar
+static const float GraphScale = 3.0f;
+static const float BarScale = 24.0f;
+// the frame time everything is measured against
+static const float BudgetMs = 1000.0f / 60.0f;
+// text is re-laid out this often, so it stays readable
+static const Uint32 LayoutIntervalMs = 250;
+
+PerfHud::PerfHud()
+	: mRenderer(nullptr)
+	, mGlyphAtlas(nullptr)
+	, mNumGlyphs(0)
+	, mLastLayoutTicks(0)
+	, mDrawMs(0.0f)
+{
+}
+
+PerfHud::~PerfHud()
+{
+	Shutdown();
+}
+
+bool PerfHud::Initialize(SDL_Renderer* renderer)
+{
+	mRenderer = renderer;
+
+	// bake the font into a 16 x 8 grid of cells, indexed by ASCII code
+	const int atlasW = 16 * GlyphW;
+	const int atlasH = 8 * GlyphH;
+	std::vector<Uint32> pixels(atlasW * atlasH, 0);
+
+	for (const Glyph& glyph : sFont)
+	{
+		int cellX = (glyph.mChar % 16) * GlyphW;
+		int cellY = (glyph.mChar / 16) * GlyphH;
+
+		for (int y = 0; y < 7; y++)
+		{
+			for (int x = 0; x < 5; x++)
+			{
+				if (glyph.mRows[y] & (0x10 >> x))
+				{
+					pixels[(cellY + y) * atlasW + cellX + x] = 0xffffffff;
+				}
+			}
+		}
+	}
+
+	mGlyphAtlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, atlasW, atlasH);
+
+	if (!mGlyphAtlas)
+	{
+		LOG("Failed to create HUD glyph atlas: %s", SDL_GetError());
+		return false;
+	}
+
+	SDL_UpdateTexture(mGlyphAtlas, nullptr, pixels.data(), atlasW * 4);
+	SDL_SetTextureBlendMode(mGlyphAtlas, SDL_BLENDMODE_BLEND);
+
+	return true;
+}
+
+void PerfHud::Shutdown()
+{
+	if (mGlyphAtlas)
+	{
+		SDL_DestroyTexture(mGlyphAtlas);
+		mGlyphAtlas = nullptr;
+	}
+}
+
+void PerfHud::Draw(const FrameStats& stats)
+{
+	if (!mGlyphAtlas)
+	{
+		return;
+	}
+
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	Uint32 ticks = SDL_GetTicks();
+
+	if (mNumGlyphs == 0 || SDL_TICKS_PASSED(ticks, mLastLayoutTicks + LayoutIntervalMs))
+	{
+		LayoutText(stats);
+		mLastLayoutTicks = ticks;
+	}
+
+	int textH = 5 * GlyphH * GlyphScale;
+	int barY = PanelY + 4 + textH;
+	int graphY = barY + 16;
+
+	SDL_Rect panel = { PanelX, PanelY, PanelW, graphY + GraphH + 4 - PanelY };
+	SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 176);
+	SDL_RenderFillRect(mRenderer, &panel);
+	SDL_SetRenderDrawBlendMode(mRenderer, SDL_BLENDMODE_NONE);
+
+	// the last frame's phases, as one stacked bar
+	// (blue input, green update, yellow render)
+	SDL_Rect bar = { PanelX + 4, barY, 0, 10 };
+	const float phases[] = { stats.mInputMs, stats.mUpdateMs, stats.mRenderMs };
+	const SDL_Color colors[] = { { 80, 160, 255, 255 }, { 80, 255, 80, 255 }, { 255, 200, 40, 255 } };
+
+	for (int i = 0; i < 3; i++)
+	{
+		bar.w = static_cast<int>(phases[i] * BarScale);
+		SDL_SetRenderDrawColor(mRenderer, colors[i].r, colors[i].g, colors[i].b, colors[i].a);
+		SDL_RenderFillRect(mRenderer, &bar);
+		bar.x += bar.w;
+	}
+
+	// frame time graph, newest on the right, red when over budget
+	// (each color is one batched fill)
+	SDL_Rect under[FrameStats::HistorySize];
+	SDL_Rect over[FrameStats::HistorySize];
+	int numUnder = 0;
+	int numOver = 0;
+	int graphBottom = graphY + GraphH;
+
+	for (int i = 0; i < FrameStats::HistorySize; i++)
+	{
+		float ms = stats.GetFrameTime(i);
+		int h = static_cast<int>(ms * GraphScale);
+		h = h > GraphH ? GraphH : h;
+
+		SDL_Rect& column = (ms > BudgetMs) ? over[numOver++] : under[numUnder++];
+		column.x = PanelX + 4 + (FrameStats::HistorySize - 1 - i) * 2;
+		column.y = graphBottom - h;
+		column.w = 2;
+		column.h = h;
+	}
+
+	SDL_SetRenderDrawColor(mRenderer, 80, 255, 80, 255);
+	SDL_RenderFillRects(mRenderer, under, numUnder);
+	SDL_SetRenderDrawColor(mRenderer, 255, 80, 80, 255);
+	SDL_RenderFillRects(mRenderer, over, numOver);
+
+	// the budget, across the graph and the bar
+	int budgetY = graphBottom - static_cast<int>(BudgetMs * GraphScale);
+	int budgetX = PanelX + 4 + static_cast<int>(BudgetMs * BarScale);
+	SDL_SetRenderDrawColor(mRenderer, 255, 255, 255, 255);
+	SDL_RenderDrawLine(mRenderer, PanelX + 4, budgetY, PanelX + 4 + FrameStats::HistorySize * 2, budgetY);
+	SDL_RenderDrawLine(mRenderer, budgetX, barY - 2, budgetX, barY + 12);
+
+	for (int i = 0; i < mNumGlyphs; i++)
+	{
+		SDL_RenderCopy(mRenderer, mGlyphAtlas, &mGlyphSrc[i], &mGlyphDst[i]);
+	}
+
+	mDrawMs = (SDL_GetPerformanceCounter() - start) * 1000.0f / SDL_GetPerformanceFrequency();
+}
+
+void PerfHud::LayoutText(const FrameStats& stats)
+{
+	mNumGlyphs = 0;
+
+	float frameMs = stats.GetFrameTime(0);
+	char line[128];
+	int x = PanelX + 4;
+	int y = PanelY + 4;
+	int lineH = GlyphH * GlyphScale;
+
+	SDL_snprintf(line, sizeof(line), "frame %.2f ms (%.0f fps)  hud %.3f ms",
+		frameMs, frameMs > 0.0f ? 1000.0f / frameMs : 0.0f, mDrawMs);
+	AddText(line, x, y);
+
+	SDL_snprintf(line, sizeof(line), "input %.2f  update %.2f  render %.2f",
+		stats.mInputMs, stats.mUpdateMs, stats.mRenderMs);
+	AddText(line, x, y + lineH);
+
+	SDL_snprintf(line, sizeof(line), "actors %d  sprites %d  components %d",
+		stats.mActors, stats.mSprites, stats.mComponents);
+	AddText(line, x, y + 2 * lineH);
+
+	SDL_snprintf(line, sizeof(line), "draws %d  texture switches %d",
+		stats.mDrawCalls, stats.mTextureSwitches);
+	AddText(line, x, y + 3 * lineH);
+
+	SDL_snprintf(line, sizeof(line), "allocs %u/frame (%.1f kb)",
+		static_cast<unsigned>(stats.mAllocs), stats.mAllocBytes / 1024.0f);
+	AddText(line, x, y + 4 * lineH);
+}
+
+void PerfHud::AddText(const char* text, int x, int y)
+{
+	for (; *text && mNumGlyphs < MaxGlyphs; text++, x += GlyphW * GlyphScale)
+	{
+		char c = *text;
+
+		if (c >= 'a' && c <= 'z')
+		{
+			c = c - 'a' + 'A';
+		}
+
+		// (spaces and unknown characters just advance)
+		if (c <= ' ' || c > '~')
+		{
+			continue;
+		}
+
+		SDL_Rect& src = mGlyphSrc[mNumGlyphs];
+		src.x = (c % 16) * GlyphW;
+		src.y = (c / 16) * GlyphH;
+		src.w = GlyphW;
+		src.h = GlyphH;
+
+		SDL_Rect& dst = mGlyphDst[mNumGlyphs];
+		dst.x = x;
+		dst.y = y;
+		dst.w = GlyphW * GlyphScale;
+		dst.h = GlyphH * GlyphScale;
+
+		mNumGlyphs++;
+	}
+}
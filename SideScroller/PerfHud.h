@@ -0,0 +1,47 @@
+#pragma once
+#include <SDL.h>
+#include "FrameStats.h"
+
+// in-game overlay with a frame time graph, per-phase bars and counters
+// (text is drawn from a glyph atlas built once from a small built-in
+// bitmap font, and only re-laid out a few times a second, so drawing
+// it is a handful of batched copies and rect fills)
+class PerfHud
+{
+public:
+	PerfHud();
+	~PerfHud();
+
+	bool Initialize(SDL_Renderer* renderer);
+	void Shutdown();
+
+	// draws over whatever is on the current render target
+	void Draw(const FrameStats& stats);
+
+	// how long the last Draw took, so the HUD can report itself
+	float GetDrawMs() const { return mDrawMs; }
+
+private:
+	// lays out the text lines into mGlyphSrc/mGlyphDst
+	void LayoutText(const FrameStats& stats);
+	void AddText(const char* text, int x, int y);
+
+	// the glyph cells are GlyphW x GlyphH in the atlas, drawn at
+	// GlyphScale times that
+	static const int GlyphW = 6;
+	static const int GlyphH = 8;
+	static const int GlyphScale = 2;
+	static const int MaxGlyphs = 512;
+
+	SDL_Renderer* mRenderer;
+	// white glyphs on transparent, 16 x 8 cells for ASCII 0-127
+	SDL_Texture* mGlyphAtlas;
+
+	// laid out text, kept between relayouts
+	SDL_Rect mGlyphSrc[MaxGlyphs];
+	SDL_Rect mGlyphDst[MaxGlyphs];
+	int mNumGlyphs;
+	Uint32 mLastLayoutTicks;
+
+	float mDrawMs;
+};
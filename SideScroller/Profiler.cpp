@@ -0,0 +1,275 @@
+#include "Profiler.h"
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Logger.h"
+
+std::atomic<bool> Profiler::sCapturing(false);
+
+#if ENABLE_PROFILER
+
+// one finished zone
+struct ZoneEvent
+{
+	const char* mName;
+	Uint64 mStart;
+	Uint64 mEnd;
+};
+
+// a thread's zones, newest overwriting oldest once full
+// (only the owning thread writes, and the trace is only read once
+// the capture has stopped, so a release on the count is all the
+// synchronization needed)
+struct ThreadRing
+{
+	static const uint32_t Capacity = 1 << 16;
+
+	ThreadRing(int threadId)
+		: mEvents(Capacity)
+		, mCount(0)
+		, mThreadId(threadId)
+	{
+	}
+
+	std::vector<ZoneEvent> mEvents;
+	std::atomic<uint32_t> mCount;
+	int mThreadId;
+	std::string mName;
+};
+
+// every thread's ring (the lock is only taken when a thread records
+// its first zone, and when exporting)
+static std::mutex sRingsMutex;
+static std::vector<std::unique_ptr<ThreadRing>> sRings;
+static thread_local ThreadRing* sThreadRing = nullptr;
+
+static int sFramesLeft = 0;
+static std::string sFileName;
+static Uint64 sCaptureStart = 0;
+
+static ThreadRing* GetThreadRing()
+{
+	if (!sThreadRing)
+	{
+		std::lock_guard<std::mutex> lock(sRingsMutex);
+		sRings.emplace_back(new ThreadRing(static_cast<int>(sRings.size()) + 1));
+		sThreadRing = sRings.back().get();
+	}
+
+	return sThreadRing;
+}
+
+void Profiler::StartCapture(int numFrames, const std::string& fileName)
+{
+	if (IsCapturing() || numFrames <= 0)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sRingsMutex);
+
+		for (auto& ring : sRings)
+		{
+			ring->mCount.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	sFramesLeft = numFrames;
+	sFileName = fileName;
+	sCaptureStart = SDL_GetPerformanceCounter();
+	sCapturing.store(true, std::memory_order_release);
+
+	LOG("Profiling %d frames to %s", numFrames, fileName.c_str());
+}
+
+void Profiler::EndFrame()
+{
+	if (!IsCapturing() || --sFramesLeft > 0)
+	{
+		return;
+	}
+
+	sCapturing.store(false, std::memory_order_release);
+	WriteTrace();
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+	GetThreadRing()->mName = name;
+}
+
+// this frame's totals (a handful of names, so a linear search is fine)
+struct ZoneTotal
+{
+	const char* mName;
+	Uint64 mTicks;
+};
+
+static std::vector<ZoneTotal> sTotals;
+
+void Profiler::AddToTotal(const char* name, Uint64 ticks)
+{
+	for (ZoneTotal& total : sTotals)
+	{
+		if (total.mName == name)
+		{
+			total.mTicks += ticks;
+			return;
+		}
+	}
+
+	sTotals.emplace_back(ZoneTotal{ name, ticks });
+}
+
+void Profiler::RecordTotals()
+{
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	for (const ZoneTotal& total : sTotals)
+	{
+		start -= total.mTicks;
+	}
+
+	for (ZoneTotal& total : sTotals)
+	{
+		Record(total.mName, start, start + total.mTicks);
+		start += total.mTicks;
+	}
+
+	sTotals.clear();
+}
+
+void Profiler::Record(const char* name, Uint64 start, Uint64 end)
+{
+	ThreadRing* ring = GetThreadRing();
+	uint32_t count = ring->mCount.load(std::memory_order_relaxed);
+
+	ZoneEvent& event = ring->mEvents[count & (ThreadRing::Capacity - 1)];
+	event.mName = name;
+	event.mStart = start;
+	event.mEnd = end;
+
+	ring->mCount.store(count + 1, std::memory_order_release);
+}
+
+// writes s as a JSON string
+static void WriteString(std::ofstream& file, const char* s)
+{
+	file << '"';
+
+	for (; *s; s++)
+	{
+		if (*s == '"' || *s == '\\')
+		{
+			file << '\\';
+		}
+
+		file << *s;
+	}
+
+	file << '"';
+}
+
+bool Profiler::WriteTrace()
+{
+	std::ofstream file(sFileName);
+
+	if (!file.is_open())
+	{
+		LOG("Failed to write profile: %s", sFileName.c_str());
+		return false;
+	}
+
+	// trace timestamps are in microseconds (written to the nanosecond,
+	// since the default six digits lose short zones seconds in)
+	double toUs = 1.0e6 / SDL_GetPerformanceFrequency();
+	file << std::fixed << std::setprecision(3);
+	size_t numEvents = 0;
+	size_t numDropped = 0;
+
+	file << "{\"traceEvents\":[\n";
+
+	std::lock_guard<std::mutex> lock(sRingsMutex);
+	bool first = true;
+
+	for (auto& ring : sRings)
+	{
+		uint32_t count = ring->mCount.load(std::memory_order_acquire);
+		// the oldest zone still in the ring
+		uint32_t begin = count > ThreadRing::Capacity ? count - ThreadRing::Capacity : 0;
+		numDropped += begin;
+
+		if (!ring->mName.empty())
+		{
+			file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+				<< ring->mThreadId << ",\"args\":{\"name\":";
+			WriteString(file, ring->mName.c_str());
+			file << "}}";
+			first = false;
+		}
+
+		for (uint32_t i = begin; i < count; i++)
+		{
+			const ZoneEvent& event = ring->mEvents[i & (ThreadRing::Capacity - 1)];
+
+			// (zones that started before the capture did)
+			if (event.mStart < sCaptureStart)
+			{
+				continue;
+			}
+
+			file << (first ? "" : ",\n") << "{\"name\":";
+			WriteString(file, event.mName);
+			file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->mThreadId
+				<< ",\"ts\":" << (event.mStart - sCaptureStart) * toUs
+				<< ",\"dur\":" << (event.mEnd - event.mStart) * toUs << "}";
+			first = false;
+			numEvents++;
+		}
+	}
+
+	file << "\n]}\n";
+
+	LOG("Wrote %u zones to %s (%u overwritten, ring holds %u per thread)",
+		static_cast<unsigned>(numEvents), sFileName.c_str(),
+		static_cast<unsigned>(numDropped), static_cast<unsigned>(ThreadRing::Capacity));
+
+	return true;
+}
+
+#else
+
+void Profiler::StartCapture(int numFrames, const std::string& fileName)
+{
+	LOG("Profiler compiled out (ENABLE_PROFILER=0)");
+}
+
+void Profiler::EndFrame()
+{
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+}
+
+void Profiler::AddToTotal(const char* name, Uint64 ticks)
+{
+}
+
+void Profiler::RecordTotals()
+{
+}
+
+void Profiler::Record(const char* name, Uint64 start, Uint64 end)
+{
+}
+
+bool Profiler::WriteTrace()
+{
+	return false;
+}
+
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+#include <SDL.h>
+#include <atomic>
+#include <string>
+
+// scoped-zone frame profiler
+// (PROFILE_ZONE("name") times the rest of the enclosing block; while a
+// capture is running, each zone is written to its thread's own ring
+// buffer, with no locks, and when the capture ends the rings are
+// exported as a Chrome trace, viewable in chrome://tracing or Perfetto)
+// build with ENABLE_PROFILER=0 to compile every zone out
+#ifndef ENABLE_PROFILER
+#define ENABLE_PROFILER 1
+#endif
+
+class Profiler
+{
+public:
+	// times its own lifetime (use PROFILE_ZONE rather than this)
+	class Zone
+	{
+	public:
+		// name must outlive the capture (a literal, or a type's name)
+		Zone(const char* name)
+			: mName(name)
+			, mStart(IsCapturing() ? SDL_GetPerformanceCounter() : 0)
+		{
+		}
+
+		~Zone()
+		{
+			if (mStart != 0)
+			{
+				Record(mName, mStart, SDL_GetPerformanceCounter());
+			}
+		}
+
+	private:
+		const char* mName;
+		Uint64 mStart;
+	};
+
+	// records the next numFrames frames, then writes them to fileName
+	// (call while no worker threads are busy)
+	static void StartCapture(int numFrames, const std::string& fileName);
+	static bool IsCapturing() { return sCapturing.load(std::memory_order_relaxed); }
+
+	// call at the end of every frame
+	static void EndFrame();
+
+	// labels the calling thread in the trace
+	static void SetThreadName(const char* name);
+
+	// for work done thousands of times a frame (each component's
+	// update): adds to name's total for the frame instead of recording
+	// a zone per call, which would overflow the ring (main thread only,
+	// and only call while capturing)
+	static void AddToTotal(const char* name, Uint64 ticks);
+	// records the frame's totals as zones laid end to end, finishing
+	// now (so call it inside the zone they belong under), each as long
+	// as everything under its name took, then clears them
+	static void RecordTotals();
+
+private:
+	static void Record(const char* name, Uint64 start, Uint64 end);
+	static bool WriteTrace();
+
+	static std::atomic<bool> sCapturing;
+};
+
+#if ENABLE_PROFILER
+#define PROFILE_JOIN2(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN2(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_JOIN(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
@@ -0,0 +1,48 @@
+#include "RenderBackend.h"
+#include "RenderCommandBuffer.h"
+#include "Texture.h"
+
+SDLRenderBackend::SDLRenderBackend(SDL_Renderer* renderer)
+	: mRenderer(renderer)
+{
+}
+
+void SDLRenderBackend::Execute(const RenderCommandBuffer& commands)
+{
+	mStats = Stats();
+	SDL_Texture* lastTexture = nullptr;
+
+	for (size_t i = 0; i < commands.GetSize(); i++)
+	{
+		const DrawCommand& command = commands[i];
+
+		// (reloads the texture if it was evicted)
+		SDL_Texture* texture = command.mTexture ? command.mTexture->Acquire() : command.mSDLTexture;
+
+		if (!texture)
+		{
+			continue;
+		}
+
+		mStats.mDrawCalls++;
+
+		if (texture != lastTexture)
+		{
+			mStats.mTextureSwitches++;
+			lastTexture = texture;
+		}
+
+		const SDL_Rect* src = command.mSrc.w > 0 ? &command.mSrc : nullptr;
+
+		// the rotating copy is much slower on the software renderer,
+		// so only use it when there is a rotation
+		if (command.mAngle != 0.0f)
+		{
+			SDL_RenderCopyEx(mRenderer, texture, src, &command.mDst, command.mAngle, nullptr, SDL_FLIP_NONE);
+		}
+		else
+		{
+			SDL_RenderCopy(mRenderer, texture, src, &command.mDst);
+		}
+	}
+}
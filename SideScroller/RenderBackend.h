@@ -0,0 +1,38 @@
+#pragma once
+#include <SDL.h>
+
+// carries out a frame's recorded draw commands
+// (on the main thread, since that's where textures can be reloaded)
+class RenderBackend
+{
+public:
+	// what the last Execute did, for the HUD
+	struct Stats
+	{
+		int mDrawCalls;
+		// commands whose texture differs from the one before
+		int mTextureSwitches;
+	};
+
+	RenderBackend() : mStats() {}
+	virtual ~RenderBackend() {}
+
+	virtual void Execute(const class RenderCommandBuffer& commands) = 0;
+
+	const Stats& GetStats() const { return mStats; }
+
+protected:
+	Stats mStats;
+};
+
+// draws through SDL_Renderer
+class SDLRenderBackend : public RenderBackend
+{
+public:
+	SDLRenderBackend(SDL_Renderer* renderer);
+
+	void Execute(const class RenderCommandBuffer& commands) override;
+
+private:
+	SDL_Renderer* mRenderer;
+};
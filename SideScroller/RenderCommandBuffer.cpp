@@ -0,0 +1,30 @@
+#include "RenderCommandBuffer.h"
+
+void RenderCommandBuffer::Draw(Texture* texture, const SDL_Rect* src, const SDL_Rect& dst, float angle)
+{
+	DrawCommand command;
+	command.mTexture = texture;
+	command.mSDLTexture = nullptr;
+	command.mSrc = src ? *src : SDL_Rect{ 0, 0, 0, 0 };
+	command.mDst = dst;
+	command.mAngle = angle;
+
+	mCommands.emplace_back(command);
+}
+
+void RenderCommandBuffer::Draw(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect& dst)
+{
+	DrawCommand command;
+	command.mTexture = nullptr;
+	command.mSDLTexture = texture;
+	command.mSrc = src ? *src : SDL_Rect{ 0, 0, 0, 0 };
+	command.mDst = dst;
+	command.mAngle = 0.0f;
+
+	mCommands.emplace_back(command);
+}
+
+void RenderCommandBuffer::Append(const RenderCommandBuffer& other)
+{
+	mCommands.insert(mCommands.end(), other.mCommands.begin(), other.mCommands.end());
+}
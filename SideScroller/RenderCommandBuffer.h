@@ -0,0 +1,40 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// one blit, recorded by a sprite's Draw and executed later by a backend
+// (plain data, so it can be written from any thread and copied around)
+struct DrawCommand
+{
+	// a cache texture, only acquired when the command is executed...
+	class Texture* mTexture;
+	// ...or, when mTexture is null, a texture the caller owns
+	SDL_Texture* mSDLTexture;
+	// the part of the texture to draw (all of it if mSrc.w is zero)
+	SDL_Rect mSrc;
+	SDL_Rect mDst;
+	// degrees clockwise around mDst's center, like SDL_RenderCopyEx
+	float mAngle;
+};
+
+// the draw commands for (part of) a frame, in draw order
+// (cleared and refilled every frame, keeping its memory, so a
+// steady scene records without allocating)
+class RenderCommandBuffer
+{
+public:
+	void Clear() { mCommands.clear(); }
+
+	// src of null draws the whole texture
+	void Draw(class Texture* texture, const SDL_Rect* src, const SDL_Rect& dst, float angle = 0.0f);
+	void Draw(SDL_Texture* texture, const SDL_Rect* src, const SDL_Rect& dst);
+
+	// adds another buffer's commands after this one's
+	void Append(const RenderCommandBuffer& other);
+
+	size_t GetSize() const { return mCommands.size(); }
+	const DrawCommand& operator[](size_t index) const { return mCommands[index]; }
+
+private:
+	std::vector<DrawCommand> mCommands;
+};
@@ -0,0 +1,86 @@
+#include "ResolutionScaler.h"
+#include "Math.h"
+#include "Logger.h"
+
+// weight of the newest frame in the average
+static const float Smoothing = 0.1f;
+// frames to wait after a change
+static const int Cooldown = 15;
+// scale up only once comfortably under budget, so it doesn't
+// bounce between two scales
+static const float RaiseBelow = 0.8f;
+static const float RaiseStep = 0.05f;
+// the largest single drop
+static const float MaxDrop = 0.15f;
+
+ResolutionScaler::ResolutionScaler()
+	: mBudgetMs(16.6f)
+	, mMinScale(0.5f)
+	, mMaxScale(1.0f)
+	, mScale(1.0f)
+	, mSmoothedMs(0.0f)
+	, mFrame(0)
+	, mCooldown(0)
+	, mNumChanges(0)
+{
+	mDecisions.reserve(MaxDecisions);
+}
+
+void ResolutionScaler::SetRange(float minScale, float maxScale)
+{
+	mMinScale = minScale;
+	mMaxScale = maxScale;
+	mScale = Math::Clamp(mScale, mMinScale, mMaxScale);
+}
+
+void ResolutionScaler::AddFrame(float frameMs)
+{
+	// start the average at the first frame instead of at zero
+	mSmoothedMs = (mFrame == 0) ? frameMs : mSmoothedMs + (frameMs - mSmoothedMs) * Smoothing;
+	mFrame++;
+
+	if (mCooldown > 0)
+	{
+		mCooldown--;
+		return;
+	}
+
+	if (mSmoothedMs > mBudgetMs)
+	{
+		// render cost goes with pixel count, the square of the scale,
+		// so this is the scale that would just meet the budget
+		float ideal = mScale * Math::Sqrt(mBudgetMs / mSmoothedMs);
+		SetScale(Math::Max(ideal, mScale - MaxDrop));
+	}
+	else if (mSmoothedMs < mBudgetMs * RaiseBelow)
+	{
+		SetScale(mScale + RaiseStep);
+	}
+}
+
+void ResolutionScaler::SetScale(float scale)
+{
+	scale = Math::Clamp(scale, mMinScale, mMaxScale);
+
+	// (already pinned at one end of the range)
+	if (Math::NearZero(scale - mScale, 0.001f))
+	{
+		return;
+	}
+
+	Decision decision{ mFrame, mSmoothedMs, mScale, scale };
+
+	if (mDecisions.size() == MaxDecisions)
+	{
+		mDecisions.erase(mDecisions.begin());
+	}
+
+	mDecisions.emplace_back(decision);
+	mNumChanges++;
+
+	LOG("Resolution scale %.2f -> %.2f (frame %u, %.2f ms smoothed, %.2f ms budget)",
+		mScale, scale, mFrame, mSmoothedMs, mBudgetMs);
+
+	mScale = scale;
+	mCooldown = Cooldown;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+// picks the scene's render resolution from how long frames take
+// (a smoothed frame time is compared against a budget, and the scale
+// steps down quickly when over it and creeps back up when well under)
+class ResolutionScaler
+{
+public:
+	// one change of scale, kept for telemetry
+	struct Decision
+	{
+		Uint32 mFrame;
+		// smoothed frame time that triggered it
+		float mSmoothedMs;
+		float mOldScale;
+		float mNewScale;
+	};
+
+	ResolutionScaler();
+
+	// frame time to aim for, in milliseconds
+	void SetBudget(float budgetMs) { mBudgetMs = budgetMs; }
+	void SetRange(float minScale, float maxScale);
+
+	// feed one frame's time, which may change the scale for the next
+	void AddFrame(float frameMs);
+
+	// fraction of the full resolution to render at, per axis
+	float GetScale() const { return mScale; }
+	float GetSmoothedMs() const { return mSmoothedMs; }
+	float GetBudget() const { return mBudgetMs; }
+	Uint32 GetFrameCount() const { return mFrame; }
+	// most recent last (only the last MaxDecisions are kept)
+	const std::vector<Decision>& GetDecisions() const { return mDecisions; }
+	int GetNumChanges() const { return mNumChanges; }
+
+private:
+	void SetScale(float scale);
+
+	static const int MaxDecisions = 64;
+
+	float mBudgetMs;
+	float mMinScale;
+	float mMaxScale;
+	float mScale;
+	// exponential moving average of the frame time
+	float mSmoothedMs;
+	Uint32 mFrame;
+	// frames left before the scale may change again
+	// (gives the average time to see the effect of the last change)
+	int mCooldown;
+	int mNumChanges;
+	std::vector<Decision> mDecisions;
+};
@@ -0,0 +1,127 @@
+#include "RotationSheet.h"
+#include "TextureCache.h"
+#include "Math.h"
+#include "Logger.h"
+
+RotationSheet::RotationSheet()
+	: mAtlas(nullptr)
+	, mSteps(0)
+	, mStepsPerRadian(0.0f)
+	, mDrawSize(0)
+	, mBytes(0)
+{
+}
+
+RotationSheet::~RotationSheet()
+{
+	if (mAtlas)
+	{
+		SDL_DestroyTexture(mAtlas);
+	}
+}
+
+bool RotationSheet::Build(TextureCache& cache, const AssetId& id, const Settings& settings)
+{
+	std::vector<Uint32> pixels;
+	int srcW = 0;
+	int srcH = 0;
+
+	if (settings.mSteps <= 0 || !cache.DecodePixels(id, pixels, srcW, srcH))
+	{
+		return false;
+	}
+
+	// every angle fits in a square the size of the diagonal
+	float diagonal = Math::Sqrt(static_cast<float>(srcW * srcW + srcH * srcH));
+	float resolution = Math::Clamp(settings.mResolution, 0.05f, 1.0f);
+	int cellSize = static_cast<int>(Math::Ceil(diagonal * resolution)) + 1;
+
+	mSteps = settings.mSteps;
+	mStepsPerRadian = mSteps / Math::TwoPi;
+	mDrawSize = static_cast<int>(Math::Ceil(cellSize / resolution));
+
+	// lay the cells out in a roughly square grid
+	int columns = static_cast<int>(Math::Ceil(Math::Sqrt(static_cast<float>(mSteps))));
+	int rows = (mSteps + columns - 1) / columns;
+	int atlasW = columns * cellSize;
+	int atlasH = rows * cellSize;
+
+	std::vector<Uint32> atlas(static_cast<size_t>(atlasW) * atlasH, 0);
+	mCells.resize(mSteps);
+
+	BlitKernels::RowFunc rowFunc = BlitKernels::GetRowFunc(settings.mFilter, BlitKernels::GetBestIsa());
+
+	// source texels per cell pixel
+	const float fixedOne = 65536.0f;
+	float scale = 1.0f / resolution;
+
+	for (int i = 0; i < mSteps; i++)
+	{
+		SDL_Rect& cell = mCells[i];
+		cell.x = (i % columns) * cellSize;
+		cell.y = (i / columns) * cellSize;
+		cell.w = cellSize;
+		cell.h = cellSize;
+
+		// the same screen to source mapping as the rasterizer, for a
+		// counter-clockwise rotation of i steps
+		float rotation = i / mStepsPerRadian;
+		float c = Math::Cos(rotation);
+		float s = -Math::Sin(rotation);
+		float ux = c * scale;
+		float uy = s * scale;
+		float vx = -s * scale;
+		float vy = c * scale;
+
+		BlitRow row;
+		row.mTexels = pixels.data();
+		row.mTexPitch = srcW;
+		row.mSrcW = srcW;
+		row.mSrcH = srcH;
+		row.mDu = static_cast<int>(ux * fixedOne);
+		row.mDv = static_cast<int>(vx * fixedOne);
+		row.mCount = cellSize;
+
+		float center = cellSize * 0.5f;
+
+		for (int y = 0; y < cellSize; y++)
+		{
+			float dx = 0.5f - center;
+			float dy = y + 0.5f - center;
+			float u = dx * ux + dy * uy + srcW * 0.5f;
+			float v = dx * vx + dy * vy + srcH * 0.5f;
+
+			row.mU = static_cast<int>(Math::Floor(u * fixedOne));
+			row.mV = static_cast<int>(Math::Floor(v * fixedOne));
+			row.mDst = &atlas[static_cast<size_t>(cell.y + y) * atlasW + cell.x];
+
+			rowFunc(row);
+		}
+	}
+
+	mAtlas = cache.CreatePixelTexture(atlas.data(), atlasW, atlasH);
+
+	if (!mAtlas)
+	{
+		return false;
+	}
+
+	mBytes = atlas.size() * sizeof(Uint32);
+	LOG("Built %d angle rotation sheet for %s (%dx%d, %u KB)",
+		mSteps, id.GetPath(), atlasW, atlasH, static_cast<unsigned>(mBytes / 1024));
+
+	return true;
+}
+
+const SDL_Rect& RotationSheet::GetCell(float rotation) const
+{
+	// round to the nearest step, wrapping negative angles around
+	int index = static_cast<int>(Math::Floor(rotation * mStepsPerRadian + 0.5f)) % mSteps;
+
+	if (index < 0)
+	{
+		index += mSteps;
+	}
+
+	return mCells[index];
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "BlitKernels.h"
+
+// a texture pre-rendered at evenly spaced angles into one atlas
+// (rotating sprites then draw the nearest angle with a plain
+// SDL_RenderCopy, which is much cheaper than SDL_RenderCopyEx on
+// the software renderer, at the cost of memory and angle snapping)
+class RotationSheet
+{
+public:
+	// quality/memory tradeoffs, chosen per texture
+	struct Settings
+	{
+		Settings()
+			: mSteps(64)
+			, mResolution(1.0f)
+			, mFilter(BlitKernels::EBilinear)
+		{
+		}
+
+		// how many angles around the full turn
+		int mSteps;
+		// size of each cell relative to the source (below 1 saves
+		// memory, and the cell is scaled back up when drawn)
+		float mResolution;
+		BlitKernels::Filter mFilter;
+	};
+
+	RotationSheet();
+	~RotationSheet();
+
+	// renders every angle of the file's image and uploads the atlas
+	bool Build(class TextureCache& cache, const class AssetId& id, const Settings& settings);
+
+	SDL_Texture* GetAtlas() const { return mAtlas; }
+
+	// the cell nearest to rotation (in radians, counter-clockwise
+	// like Actor's rotation)
+	const SDL_Rect& GetCell(float rotation) const;
+
+	// the size a cell covers on screen at a scale of 1
+	// (larger than the source, to fit the rotated corners)
+	int GetDrawSize() const { return mDrawSize; }
+	size_t GetBytes() const { return mBytes; }
+
+private:
+	SDL_Texture* mAtlas;
+	std::vector<SDL_Rect> mCells;
+	int mSteps;
+	// cells per radian
+	float mStepsPerRadian;
+	int mDrawSize;
+	size_t mBytes;
+};
@@ -0,0 +1,167 @@
+#include "Scenario.h"
+#include <cstdlib>
+#include <fstream>
+#include "Logger.h"
+
+Scenario::Scenario()
+	: mName("default")
+	, mAsteroids(20)
+	, mLasersPerSecond(0)
+	, mAnimSprites(0)
+	, mBackgroundLayers(2)
+	, mWorldWidth(1024.0f)
+	, mWorldHeight(768.0f)
+{
+}
+
+bool Scenario::GetPreset(const std::string& name, Scenario& scenario)
+{
+	// each rung is ten times the last, 80% asteroids and 20% animated
+	// sprites, in a world with ten times the area (each side grows by
+	// the square root of ten) so the density stays the same
+	struct Preset
+	{
+		const char* mName;
+		int mAsteroids;
+		int mLasersPerSecond;
+		int mAnimSprites;
+		int mBackgroundLayers;
+		float mWorldWidth;
+		float mWorldHeight;
+	};
+
+	static const Preset presets[] = {
+		{ "1k", 800, 20, 200, 2, 2048.0f, 1536.0f },
+		{ "10k", 8000, 100, 2000, 2, 6476.0f, 4857.0f },
+		{ "100k", 80000, 500, 20000, 4, 20480.0f, 15360.0f },
+		{ "1m", 800000, 1000, 200000, 4, 64763.0f, 48573.0f },
+	};
+
+	for (const Preset& preset : presets)
+	{
+		if (name == preset.mName)
+		{
+			scenario.mName = preset.mName;
+			scenario.mAsteroids = preset.mAsteroids;
+			scenario.mLasersPerSecond = preset.mLasersPerSecond;
+			scenario.mAnimSprites = preset.mAnimSprites;
+			scenario.mBackgroundLayers = preset.mBackgroundLayers;
+			scenario.mWorldWidth = preset.mWorldWidth;
+			scenario.mWorldHeight = preset.mWorldHeight;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// without surrounding whitespace
+static std::string Trim(const std::string& s)
+{
+	size_t begin = s.find_first_not_of(" \t\r\n");
+	size_t end = s.find_last_not_of(" \t\r\n");
+	return begin == std::string::npos ? std::string() : s.substr(begin, end - begin + 1);
+}
+
+bool Scenario::Load(const std::string& description)
+{
+	if (GetPreset(description, *this))
+	{
+		return true;
+	}
+
+	bool isInline = description.find('=') != std::string::npos;
+	std::string text;
+
+	if (isInline)
+	{
+		text = description;
+		mName = "custom";
+	}
+	else
+	{
+		std::ifstream file(description);
+
+		if (!file.is_open())
+		{
+			LOG("Unknown scenario (not a preset, or a file): %s", description.c_str());
+			return false;
+		}
+
+		text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		mName = description;
+	}
+
+	// pairs are separated by commas inline, and by lines in files
+	// (where # starts a comment)
+	char separator = isInline ? ',' : '\n';
+	size_t start = 0;
+
+	while (start <= text.size())
+	{
+		size_t end = text.find(separator, start);
+		end = end == std::string::npos ? text.size() : end;
+
+		std::string pair = text.substr(start, end - start);
+		pair = Trim(pair.substr(0, pair.find('#')));
+		start = end + 1;
+
+		if (pair.empty())
+		{
+			continue;
+		}
+
+		size_t equals = pair.find('=');
+
+		if (equals == std::string::npos || !Set(Trim(pair.substr(0, equals)), Trim(pair.substr(equals + 1))))
+		{
+			LOG("Bad scenario setting in %s: %s", mName.c_str(), pair.c_str());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Scenario::Set(const std::string& key, const std::string& value)
+{
+	if (key == "preset")
+	{
+		// (settings after it override the preset's)
+		return GetPreset(value, *this);
+	}
+	else if (key == "name")
+	{
+		mName = value;
+	}
+	else if (key == "asteroids")
+	{
+		mAsteroids = std::atoi(value.c_str());
+	}
+	else if (key == "lasers")
+	{
+		mLasersPerSecond = std::atoi(value.c_str());
+	}
+	else if (key == "anim")
+	{
+		mAnimSprites = std::atoi(value.c_str());
+	}
+	else if (key == "layers")
+	{
+		mBackgroundLayers = std::atoi(value.c_str());
+	}
+	else if (key == "width")
+	{
+		mWorldWidth = static_cast<float>(std::atof(value.c_str()));
+	}
+	else if (key == "height")
+	{
+		mWorldHeight = static_cast<float>(std::atof(value.c_str()));
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+
+// what a stress test world is made of
+// (loaded from a preset, a file of "key = value" lines, or the same
+// pairs inline, comma separated, e.g. "asteroids=5000,lasers=50")
+struct Scenario
+{
+	Scenario();
+
+	// from a preset name, an inline description or a file, in that
+	// order of preference (false, with a log, if it's none of them)
+	bool Load(const std::string& description);
+
+	// the preset ladder: 1k, 10k, 100k and 1m entities
+	static bool GetPreset(const std::string& name, Scenario& scenario);
+
+	// total actors it spawns up front
+	int GetNumEntities() const { return mAsteroids + mAnimSprites; }
+
+	std::string mName;
+	int mAsteroids;
+	// lasers fired from random places in the world, every second
+	int mLasersPerSecond;
+	int mAnimSprites;
+	int mBackgroundLayers;
+	// asteroids wrap around this, rather than the window
+	float mWorldWidth;
+	float mWorldHeight;
+
+private:
+	// applies one "key = value", false if the key is unknown
+	bool Set(const std::string& key, const std::string& value);
+};
@@ -0,0 +1,195 @@
+#include "SharedMemory.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SharedMemory::SharedMemory()
+	: mData(nullptr)
+	, mSize(0)
+#ifdef _WIN32
+	, mMapping(nullptr)
+#else
+	, mName()
+	, mCreated(false)
+#endif
+{
+}
+
+SharedMemory::~SharedMemory()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool SharedMemory::Create(const char* name, size_t size)
+{
+	Close();
+
+	unsigned long long wide = size;
+	mMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(wide >> 32), static_cast<DWORD>(wide), name);
+
+	if (!mMapping)
+	{
+		return false;
+	}
+
+	mData = MapViewOfFile(mMapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+
+	if (!mData)
+	{
+		Close();
+		return false;
+	}
+
+	mSize = size;
+	return true;
+}
+
+bool SharedMemory::Open(const char* name)
+{
+	Close();
+
+	mMapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+
+	if (!mMapping)
+	{
+		return false;
+	}
+
+	mData = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (!mData)
+	{
+		Close();
+		return false;
+	}
+
+	// (the view covers the whole mapping, rounded up to a page)
+	MEMORY_BASIC_INFORMATION info;
+	VirtualQuery(mData, &info, sizeof(info));
+	mSize = info.RegionSize;
+	return true;
+}
+
+void SharedMemory::Close()
+{
+	if (mData)
+	{
+		UnmapViewOfFile(mData);
+		mData = nullptr;
+	}
+
+	if (mMapping)
+	{
+		CloseHandle(mMapping);
+		mMapping = nullptr;
+	}
+
+	mSize = 0;
+}
+
+#else
+
+bool SharedMemory::Create(const char* name, size_t size)
+{
+	Close();
+
+	// (shm names start with a slash)
+	std::snprintf(mName, sizeof(mName), "/%s", name);
+
+	// replace any block a crashed run left behind
+	shm_unlink(mName);
+	int fd = shm_open(mName, O_CREAT | O_RDWR | O_TRUNC, 0644);
+
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	mCreated = true;
+
+	if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+	{
+		close(fd);
+		Close();
+		return false;
+	}
+
+	void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	// (the mapping keeps the block open)
+	close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	mData = data;
+	mSize = size;
+	return true;
+}
+
+bool SharedMemory::Open(const char* name)
+{
+	Close();
+
+	char path[256];
+	std::snprintf(path, sizeof(path), "/%s", name);
+	int fd = shm_open(path, O_RDONLY, 0);
+
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+
+	if (fstat(fd, &info) != 0 || info.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+
+	mData = data;
+	mSize = static_cast<size_t>(info.st_size);
+	return true;
+}
+
+void SharedMemory::Close()
+{
+	if (mData)
+	{
+		munmap(mData, mSize);
+		mData = nullptr;
+	}
+
+	if (mCreated)
+	{
+		shm_unlink(mName);
+		mCreated = false;
+	}
+
+	mSize = 0;
+}
+
+#endif
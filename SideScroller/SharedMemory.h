@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+
+// a named block of memory other processes can map
+// (a pagefile backed file mapping on Windows, POSIX shm elsewhere)
+class SharedMemory
+{
+public:
+	SharedMemory();
+	~SharedMemory();
+
+	// makes a new zeroed block, for writing (the creator's block goes
+	// away when it closes and the last reader lets go)
+	bool Create(const char* name, size_t size);
+	// maps an existing block, read only
+	bool Open(const char* name);
+	void Close();
+
+	void* GetData() const { return mData; }
+	size_t GetSize() const { return mSize; }
+
+private:
+	void* mData;
+	size_t mSize;
+#ifdef _WIN32
+	void* mMapping;
+#else
+	// the shm name, kept by the creator to unlink it on close
+	char mName[256];
+	bool mCreated;
+#endif
+};
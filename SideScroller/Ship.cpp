@@ -3,6 +3,7 @@
 #include "InputComponent.h"
 #include "Game.h"
 #include "Laser.h"
+#include "Assets.h"
 
 Ship::Ship(Game* game)
 	: Actor(game)
@@ -11,14 +12,12 @@ Ship::Ship(Game* game)
 	// create animated sprite component
 	AnimSpriteComponent* asc = new AnimSpriteComponent(this);
 
-	std::vector<SDL_Texture*> anims = {
-		game->GetTexture("Assets/Ship01.png"),
-		game->GetTexture("Assets/Ship02.png"),
-		game->GetTexture("Assets/Ship03.png"),
-		game->GetTexture("Assets/Ship04.png"),
-	};
-
-	asc->SetAnimTextures(anims);
+	asc->SetClip(game->GetAnimClip({
+		Assets::Ship01,
+		Assets::Ship02,
+		Assets::Ship03,
+		Assets::Ship04,
+	}, 24.0f));
 
 	// create an input component and set keys/speed
 	InputComponent* ic = new InputComponent(this);
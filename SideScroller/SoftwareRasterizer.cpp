@@ -0,0 +1,265 @@
+#include "SoftwareRasterizer.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+#include "Math.h"
+#include "RenderCommandBuffer.h"
+#include "Profiler.h"
+#include "Logger.h"
+
+SoftwareRasterizer::SoftwareRasterizer()
+	: mRenderer(nullptr)
+	, mTarget(nullptr)
+	, mThreadPool(nullptr)
+	, mFilter(BlitKernels::ENearest)
+	, mRowFunc(nullptr)
+	, mWidth(0)
+	, mHeight(0)
+	, mTilesX(0)
+	, mTilesY(0)
+{
+}
+
+SoftwareRasterizer::~SoftwareRasterizer()
+{
+	Shutdown();
+}
+
+bool SoftwareRasterizer::Initialize(SDL_Renderer* renderer, int width, int height, ThreadPool* pool)
+{
+	mRenderer = renderer;
+	mThreadPool = pool;
+	mWidth = width;
+	mHeight = height;
+
+	mTarget = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+
+	if (!mTarget)
+	{
+		LOG("Failed to create rasterizer target: %s", SDL_GetError());
+		return false;
+	}
+
+	// the frame covers the whole screen, so no blending on upload
+	SDL_SetTextureBlendMode(mTarget, SDL_BLENDMODE_NONE);
+
+	mFramebuffer.resize(static_cast<size_t>(width) * height);
+
+	mTilesX = (width + TileSize - 1) / TileSize;
+	mTilesY = (height + TileSize - 1) / TileSize;
+	mBins.resize(mTilesX * mTilesY);
+
+	SetFilter(mFilter);
+	LOG("Rasterizer using %s blit kernels", BlitKernels::GetIsaName(BlitKernels::GetBestIsa()));
+
+	return true;
+}
+
+void SoftwareRasterizer::SetFilter(BlitKernels::Filter filter)
+{
+	mFilter = filter;
+	mRowFunc = BlitKernels::GetRowFunc(filter, BlitKernels::GetBestIsa());
+}
+
+void SoftwareRasterizer::Shutdown()
+{
+	if (mTarget)
+	{
+		SDL_DestroyTexture(mTarget);
+		mTarget = nullptr;
+	}
+}
+
+void SoftwareRasterizer::DrawSprite(Texture* texture, const SDL_Rect* src, const SDL_Rect& dst, double angle)
+{
+	// makes sure the texture (and its pixels) are resident
+	texture->Acquire();
+	const Uint32* pixels = texture->GetPixels();
+
+	if (!pixels || dst.w <= 0 || dst.h <= 0)
+	{
+		return;
+	}
+
+	SDL_Rect full = { 0, 0, texture->GetWidth(), texture->GetHeight() };
+
+	if (!src)
+	{
+		src = &full;
+	}
+
+	Quad quad;
+	quad.mTexPitch = texture->GetWidth();
+	quad.mTexels = pixels + src->y * quad.mTexPitch + src->x;
+	quad.mSrcW = src->w;
+	quad.mSrcH = src->h;
+	quad.mCenterX = dst.x + dst.w * 0.5f;
+	quad.mCenterY = dst.y + dst.h * 0.5f;
+
+	// screen offsets from the center map to source texels by
+	// undoing the rotation, then the scale
+	float radians = Math::ToRadians(static_cast<float>(angle));
+	float c = Math::Cos(radians);
+	float s = Math::Sin(radians);
+	float scaleX = static_cast<float>(src->w) / dst.w;
+	float scaleY = static_cast<float>(src->h) / dst.h;
+
+	quad.mUx = c * scaleX;
+	quad.mUy = s * scaleX;
+	quad.mVx = -s * scaleY;
+	quad.mVy = c * scaleY;
+
+	// the box around the rotated corners
+	float halfW = dst.w * 0.5f;
+	float halfH = dst.h * 0.5f;
+
+	// bilinear edges fade out over an extra half texel
+	if (mFilter == BlitKernels::EBilinear)
+	{
+		halfW += 0.5f / scaleX;
+		halfH += 0.5f / scaleY;
+	}
+
+	float extentX = Math::Abs(c) * halfW + Math::Abs(s) * halfH;
+	float extentY = Math::Abs(s) * halfW + Math::Abs(c) * halfH;
+
+	SDL_Rect bounds;
+	bounds.x = static_cast<int>(Math::Floor(quad.mCenterX - extentX));
+	bounds.y = static_cast<int>(Math::Floor(quad.mCenterY - extentY));
+	bounds.w = static_cast<int>(Math::Floor(quad.mCenterX + extentX)) + 1 - bounds.x;
+	bounds.h = static_cast<int>(Math::Floor(quad.mCenterY + extentY)) + 1 - bounds.y;
+
+	SDL_Rect screen = { 0, 0, mWidth, mHeight };
+
+	if (!SDL_IntersectRect(&bounds, &screen, &quad.mBounds))
+	{
+		return;
+	}
+
+	// bin into every tile the bounds touch
+	int index = static_cast<int>(mQuads.size());
+	mQuads.emplace_back(quad);
+
+	int tileX0 = quad.mBounds.x / TileSize;
+	int tileY0 = quad.mBounds.y / TileSize;
+	int tileX1 = (quad.mBounds.x + quad.mBounds.w - 1) / TileSize;
+	int tileY1 = (quad.mBounds.y + quad.mBounds.h - 1) / TileSize;
+
+	for (int ty = tileY0; ty <= tileY1; ty++)
+	{
+		for (int tx = tileX0; tx <= tileX1; tx++)
+		{
+			mBins[ty * mTilesX + tx].emplace_back(index);
+		}
+	}
+}
+
+void SoftwareRasterizer::Execute(const RenderCommandBuffer& commands)
+{
+	// (draws here are quads binned for the tiles)
+	mStats = Stats();
+	const Texture* lastTexture = nullptr;
+
+	for (size_t i = 0; i < commands.GetSize(); i++)
+	{
+		const DrawCommand& command = commands[i];
+
+		if (command.mTexture)
+		{
+			mStats.mDrawCalls++;
+
+			if (command.mTexture != lastTexture)
+			{
+				mStats.mTextureSwitches++;
+				lastTexture = command.mTexture;
+			}
+
+			DrawSprite(command.mTexture, command.mSrc.w > 0 ? &command.mSrc : nullptr, command.mDst, command.mAngle);
+		}
+	}
+
+	Present();
+}
+
+void SoftwareRasterizer::Present()
+{
+	// tiles don't overlap, so they can be filled in any order on any thread
+	mThreadPool->ParallelFor(mBins.size(), [this](size_t tile) {
+		RasterizeTile(static_cast<int>(tile));
+	});
+
+	PROFILE_ZONE("UploadFramebuffer");
+	SDL_UpdateTexture(mTarget, nullptr, mFramebuffer.data(), mWidth * 4);
+	SDL_RenderCopy(mRenderer, mTarget, nullptr, nullptr);
+
+	// ready for next frame (keeping capacity)
+	mQuads.clear();
+
+	for (auto& bin : mBins)
+	{
+		bin.clear();
+	}
+}
+
+void SoftwareRasterizer::RasterizeTile(int tile)
+{
+	PROFILE_ZONE("RasterizeTile");
+
+	SDL_Rect clip;
+	clip.x = (tile % mTilesX) * TileSize;
+	clip.y = (tile / mTilesX) * TileSize;
+	clip.w = Math::Min(TileSize, mWidth - clip.x);
+	clip.h = Math::Min(TileSize, mHeight - clip.y);
+
+	// clear to opaque black
+	for (int y = clip.y; y < clip.y + clip.h; y++)
+	{
+		Uint32* row = &mFramebuffer[y * mWidth + clip.x];
+
+		for (int x = 0; x < clip.w; x++)
+		{
+			row[x] = 0xff000000;
+		}
+	}
+
+	// in draw order, so later sprites land on top
+	for (int index : mBins[tile])
+	{
+		const Quad& quad = mQuads[index];
+		SDL_Rect area;
+
+		if (SDL_IntersectRect(&quad.mBounds, &clip, &area))
+		{
+			RasterizeQuad(quad, area);
+		}
+	}
+}
+
+void SoftwareRasterizer::RasterizeQuad(const Quad& quad, const SDL_Rect& clip)
+{
+	// source coordinates are stepped in 16.16 fixed point
+	const float fixedOne = 65536.0f;
+
+	BlitRow row;
+	row.mTexels = quad.mTexels;
+	row.mTexPitch = quad.mTexPitch;
+	row.mSrcW = quad.mSrcW;
+	row.mSrcH = quad.mSrcH;
+	row.mDu = static_cast<int>(quad.mUx * fixedOne);
+	row.mDv = static_cast<int>(quad.mVx * fixedOne);
+	row.mCount = clip.w;
+
+	for (int y = clip.y; y < clip.y + clip.h; y++)
+	{
+		// source position of the first pixel's center in this row
+		float dx = clip.x + 0.5f - quad.mCenterX;
+		float dy = y + 0.5f - quad.mCenterY;
+		float u = dx * quad.mUx + dy * quad.mUy + quad.mSrcW * 0.5f;
+		float v = dx * quad.mVx + dy * quad.mVy + quad.mSrcH * 0.5f;
+
+		row.mU = static_cast<int>(Math::Floor(u * fixedOne));
+		row.mV = static_cast<int>(Math::Floor(v * fixedOne));
+		row.mDst = &mFramebuffer[y * mWidth + clip.x];
+
+		mRowFunc(row);
+	}
+}
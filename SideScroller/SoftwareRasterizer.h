@@ -0,0 +1,83 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "BlitKernels.h"
+#include "RenderBackend.h"
+
+// draws sprites on the CPU instead of through SDL_Renderer
+// (the screen is split into tiles, each sprite is binned into the
+// tiles it touches, and the tiles are filled in parallel on the
+// thread pool, then the frame goes up as one texture upload)
+class SoftwareRasterizer : public RenderBackend
+{
+public:
+	SoftwareRasterizer();
+	~SoftwareRasterizer();
+
+	bool Initialize(SDL_Renderer* renderer, int width, int height, class ThreadPool* pool);
+	void Shutdown();
+
+	// nearest by default; bilinear also softens the sprite edges
+	void SetFilter(BlitKernels::Filter filter);
+
+	// queues part of a texture (all of it if src is null) to be drawn
+	// into dst, rotated angle degrees clockwise around dst's center
+	// (same meaning as SDL_RenderCopyEx)
+	void DrawSprite(class Texture* texture, const SDL_Rect* src, const SDL_Rect& dst, double angle);
+
+	// rasterizes everything queued this frame and copies it to the renderer
+	void Present();
+
+	// queues every command, then presents
+	// (commands drawing SDL textures are skipped, there are no
+	// pixels to sample from them)
+	void Execute(const class RenderCommandBuffer& commands) override;
+
+	int GetQueuedSprites() const { return static_cast<int>(mQuads.size()); }
+
+private:
+	// a sprite ready to rasterize
+	struct Quad
+	{
+		// top left of the source region
+		const Uint32* mTexels;
+		int mTexPitch;
+		int mSrcW;
+		int mSrcH;
+		// screen-space box the rotated sprite covers
+		SDL_Rect mBounds;
+		// maps screen to source, relative to the sprite's center
+		float mCenterX;
+		float mCenterY;
+		float mUx;
+		float mUy;
+		float mVx;
+		float mVy;
+	};
+
+	void RasterizeTile(int tile);
+	void RasterizeQuad(const Quad& quad, const SDL_Rect& clip);
+
+	static const int TileSize = 64;
+
+	SDL_Renderer* mRenderer;
+	// streaming texture the framebuffer is uploaded into
+	SDL_Texture* mTarget;
+	class ThreadPool* mThreadPool;
+
+	BlitKernels::Filter mFilter;
+	// fills one row of a quad (SIMD where the CPU has it)
+	BlitKernels::RowFunc mRowFunc;
+
+	int mWidth;
+	int mHeight;
+	int mTilesX;
+	int mTilesY;
+
+	// ARGB8888
+	std::vector<Uint32> mFramebuffer;
+	std::vector<Quad> mQuads;
+	// indices into mQuads for each tile, in draw order
+	// (kept between frames so they stop allocating)
+	std::vector<std::vector<int>> mBins;
+};
@@ -1,13 +1,14 @@
 #include "SpriteComponent.h"
 #include "Actor.h"
 #include "Game.h"
+#include "RenderCommandBuffer.h"
+#include "RotationSheet.h"
 
 SpriteComponent::SpriteComponent(Actor* owner, int drawOrder)
 	: Component(owner)
 	, mTexture(nullptr)
+	, mRotationSheet(nullptr)
 	, mDrawOrder(drawOrder)
-	, mTexHeight(0)
-	, mTexWidth(0)
 {
 	mOwner->GetGame()->AddSprite(this);
 }
@@ -17,31 +18,34 @@ SpriteComponent::~SpriteComponent()
 	mOwner->GetGame()->RemoveSprite(this);
 }
 
-void SpriteComponent::Draw(SDL_Renderer* renderer)
+void SpriteComponent::Draw(RenderCommandBuffer& commands)
 {
-	if (mTexture)
+	if (mRotationSheet)
 	{
+		// the nearest pre-rotated cell, drawn without rotation
 		SDL_Rect r;
-		// Scale the width/height by owner's scale
-		r.w = static_cast<int>(mTexWidth * mOwner->GetScale());
-		r.h = static_cast<int>(mTexHeight * mOwner->GetScale());
-		// Center the rectangle around the position of the owner
+		r.w = static_cast<int>(mRotationSheet->GetDrawSize() * mOwner->GetScale());
+		r.h = r.w;
 		r.x = static_cast<int>(mOwner->GetPosition().x - r.w / 2);
 		r.y = static_cast<int>(mOwner->GetPosition().y - r.h / 2);
 
-		SDL_RenderCopyEx(renderer,
-			mTexture,
-			nullptr,
-			&r,
-			-Math::ToDegrees(mOwner->GetRotation()),
-			nullptr,
-			SDL_FLIP_NONE);
+		commands.Draw(mRotationSheet->GetAtlas(), &mRotationSheet->GetCell(mOwner->GetRotation()), r);
+	}
+	else if (mTexture)
+	{
+		DrawTexture(commands, mTexture, nullptr, mTexture->GetWidth(), mTexture->GetHeight());
 	}
 }
 
-void SpriteComponent::SetTexture(SDL_Texture* texture)
+void SpriteComponent::DrawTexture(RenderCommandBuffer& commands, Texture* texture, const SDL_Rect* src, int width, int height)
 {
-	mTexture = texture;
+	SDL_Rect r;
+	// Scale the width/height by owner's scale
+	r.w = static_cast<int>(width * mOwner->GetScale());
+	r.h = static_cast<int>(height * mOwner->GetScale());
+	// Center the rectangle around the position of the owner
+	r.x = static_cast<int>(mOwner->GetPosition().x - r.w / 2);
+	r.y = static_cast<int>(mOwner->GetPosition().y - r.h / 2);
 
-	SDL_QueryTexture(texture, nullptr, nullptr, &mTexWidth, &mTexHeight);
+	commands.Draw(texture, src, r, -Math::ToDegrees(mOwner->GetRotation()));
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "SDL.h"
 #include "Component.h"
+#include "Texture.h"
 
 class SpriteComponent : public Component
 {
@@ -9,17 +10,31 @@ public:
 	SpriteComponent(class Actor* owner, int drawOrder = 100);
 	~SpriteComponent();
 
-	virtual void Draw(SDL_Renderer* renderer);
-	virtual void SetTexture(SDL_Texture* texture);
+	const char* GetName() const override { return "SpriteComponent"; }
+
+	// records the sprite's draw commands
+	// (may be called on worker threads, so it must only read the
+	// game, and leave loading and acquiring textures to the backend)
+	virtual void Draw(class RenderCommandBuffer& commands);
+	virtual void SetTexture(Texture* texture) { mTexture = texture; }
+	// draw the owner's rotation from this pre-rotated version of the
+	// texture instead (null to go back to rotating mTexture)
+	void SetRotationSheet(const class RotationSheet* sheet) { mRotationSheet = sheet; }
 
 	int GetDrawOrder() const { return mDrawOrder; }
-	int GetTexHeight() const { return mTexHeight; }
-	int GetTexWidth() const { return mTexWidth; }
+	Texture* GetTexture() const { return mTexture; }
+	// (sizes come from the handle, which knows them from load time)
+	int GetTexHeight() const { return mTexture ? mTexture->GetHeight() : 0; }
+	int GetTexWidth() const { return mTexture ? mTexture->GetWidth() : 0; }
+
+protected:
+	// draws (part of) a texture at width x height, scaled, rotated
+	// and centered on the owner
+	void DrawTexture(class RenderCommandBuffer& commands, Texture* texture, const SDL_Rect* src, int width, int height);
 
 private:
-	SDL_Texture* mTexture;
+	Texture* mTexture;
+	const class RotationSheet* mRotationSheet;
 	int mDrawOrder;
-	int mTexWidth;
-	int mTexHeight;
 };
 
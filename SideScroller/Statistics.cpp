@@ -0,0 +1,199 @@
+#include "Statistics.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+
+namespace Statistics
+{
+	// (partially sorts samples, which the callers own)
+	static float PercentileInPlace(std::vector<float>& samples, float p)
+	{
+		if (samples.empty())
+		{
+			return 0.0f;
+		}
+
+		size_t rank = static_cast<size_t>(p / 100.0f * (samples.size() - 1) + 0.5f);
+		std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+		return samples[rank];
+	}
+
+	float Percentile(std::vector<float> samples, float p)
+	{
+		return PercentileInPlace(samples, p);
+	}
+
+	// the probability of U >= u with n1 and n2 samples and no ties,
+	// counting the orderings that give each U
+	static double ExactGreater(int n1, int n2, double u)
+	{
+		// ways[i][j][k]: orderings of i of one and j of the other with U = k
+		int maxU = n1 * n2;
+		std::vector<std::vector<std::vector<double>>> ways(n1 + 1,
+			std::vector<std::vector<double>>(n2 + 1, std::vector<double>(maxU + 1, 0.0)));
+
+		for (int i = 0; i <= n1; i++)
+		{
+			for (int j = 0; j <= n2; j++)
+			{
+				if (i == 0 || j == 0)
+				{
+					ways[i][j][0] = 1.0;
+					continue;
+				}
+
+				// the largest sample is either one of the i (beating all j)
+				// or one of the j
+				for (int k = 0; k <= i * j; k++)
+				{
+					ways[i][j][k] = (k >= j ? ways[i - 1][j][k - j] : 0.0) + ways[i][j - 1][k];
+				}
+			}
+		}
+
+		double total = 0.0;
+		double greater = 0.0;
+
+		for (int k = 0; k <= maxU; k++)
+		{
+			total += ways[n1][n2][k];
+			greater += k >= u - 1.0e-9 ? ways[n1][n2][k] : 0.0;
+		}
+
+		return greater / total;
+	}
+
+	double MannWhitneyGreater(const std::vector<float>& before, const std::vector<float>& after)
+	{
+		double n1 = static_cast<double>(after.size());
+		double n2 = static_cast<double>(before.size());
+
+		if (n1 == 0.0 || n2 == 0.0)
+		{
+			return 1.0;
+		}
+
+		// rank everything together (ties get the average of their ranks)
+		std::vector<std::pair<float, bool>> all;
+		all.reserve(before.size() + after.size());
+
+		for (float sample : before)
+		{
+			all.emplace_back(sample, false);
+		}
+
+		for (float sample : after)
+		{
+			all.emplace_back(sample, true);
+		}
+
+		std::sort(all.begin(), all.end());
+
+		double afterRanks = 0.0;
+		double tieTerm = 0.0;
+
+		for (size_t i = 0; i < all.size();)
+		{
+			size_t j = i;
+
+			while (j < all.size() && all[j].first == all[i].first)
+			{
+				j++;
+			}
+
+			// ranks i + 1 to j
+			double rank = (i + 1 + j) * 0.5;
+			double ties = static_cast<double>(j - i);
+			tieTerm += ties * ties * ties - ties;
+
+			for (size_t k = i; k < j; k++)
+			{
+				afterRanks += all[k].second ? rank : 0.0;
+			}
+
+			i = j;
+		}
+
+		double n = n1 + n2;
+		double u = afterRanks - n1 * (n1 + 1.0) * 0.5;
+
+		if (tieTerm == 0.0 && n1 * n2 <= 400.0)
+		{
+			return ExactGreater(static_cast<int>(n1), static_cast<int>(n2), u);
+		}
+
+		double mean = n1 * n2 * 0.5;
+		double variance = n1 * n2 / 12.0 * ((n + 1.0) - tieTerm / (n * (n - 1.0)));
+
+		if (variance <= 0.0)
+		{
+			return 1.0;
+		}
+
+		// (with a continuity correction)
+		double z = (u - mean - 0.5) / std::sqrt(variance);
+		return 0.5 * std::erfc(z / std::sqrt(2.0));
+	}
+
+	double MannWhitneySmallestP(int beforeCount, int afterCount)
+	{
+		std::vector<float> before;
+		std::vector<float> after;
+
+		for (int i = 0; i < beforeCount; i++)
+		{
+			before.emplace_back(static_cast<float>(i));
+		}
+
+		for (int i = 0; i < afterCount; i++)
+		{
+			after.emplace_back(static_cast<float>(beforeCount + i));
+		}
+
+		return MannWhitneyGreater(before, after);
+	}
+
+	// the p-th percentile of count runs drawn from runs, all frames together
+	static float ResampledPercentile(const std::vector<std::vector<float>>& runs, std::mt19937& generator,
+		float p, std::vector<float>& pooled)
+	{
+		std::uniform_int_distribution<size_t> pick(0, runs.size() - 1);
+		pooled.clear();
+
+		for (size_t i = 0; i < runs.size(); i++)
+		{
+			const std::vector<float>& run = runs[pick(generator)];
+			pooled.insert(pooled.end(), run.begin(), run.end());
+		}
+
+		return PercentileInPlace(pooled, p);
+	}
+
+	void BootstrapPercentileChange(const std::vector<std::vector<float>>& beforeRuns,
+		const std::vector<std::vector<float>>& afterRuns, float p, int iterations, double& low, double& high)
+	{
+		low = 0.0;
+		high = 0.0;
+
+		if (beforeRuns.empty() || afterRuns.empty() || iterations <= 0)
+		{
+			return;
+		}
+
+		std::mt19937 generator(1234);
+		std::vector<float> pooled;
+		std::vector<double> changes(iterations);
+
+		for (int i = 0; i < iterations; i++)
+		{
+			double b = ResampledPercentile(beforeRuns, generator, p, pooled);
+			double a = ResampledPercentile(afterRuns, generator, p, pooled);
+			changes[i] = b > 0.0 ? (a - b) / b : 0.0;
+		}
+
+		std::sort(changes.begin(), changes.end());
+		low = changes[static_cast<size_t>(iterations * 0.025)];
+		high = changes[std::min(static_cast<size_t>(iterations * 0.975), changes.size() - 1)];
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <vector>
+
+// the statistical tests that benchmark comparisons use to tell a real
+// change in frame times from noise. frames within a run aren't
+// independent (one slow stretch spans many), so the tests take whole
+// runs as their samples
+namespace Statistics
+{
+	// the p-th percentile (0-100) of samples, nearest rank
+	float Percentile(std::vector<float> samples, float p);
+
+	// one-sided Mann-Whitney U test: the probability of after looking
+	// at least this much larger than before if both came from the same
+	// distribution (exact for the few samples a handful of runs give,
+	// otherwise the normal approximation, corrected for ties)
+	double MannWhitneyGreater(const std::vector<float>& before, const std::vector<float>& after);
+	// the smallest p MannWhitneyGreater can give with this many samples
+	// (every after larger than every before)
+	double MannWhitneySmallestP(int beforeCount, int afterCount);
+
+	// a 95% bootstrap confidence interval on how much the p-th
+	// percentile of all frames changed from before to after, as a
+	// fraction of before, resampling whole runs (resamples are drawn
+	// from a fixed seed, so results repeat)
+	void BootstrapPercentileChange(const std::vector<std::vector<float>>& beforeRuns,
+		const std::vector<std::vector<float>>& afterRuns, float p, int iterations, double& low, double& high);
+}
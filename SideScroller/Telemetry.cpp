@@ -0,0 +1,85 @@
+#include "Telemetry.h"
+#include <SDL.h>
+#include <new>
+#include "FrameStats.h"
+#include "Logger.h"
+
+Telemetry::Telemetry()
+	: mHeader(nullptr)
+	, mRecords(nullptr)
+	, mWritten(0)
+{
+}
+
+Telemetry::~Telemetry()
+{
+	Shutdown();
+}
+
+bool Telemetry::Initialize(const char* name, int capacity)
+{
+	size_t size = TelemetryHeader::DataOffset + capacity * sizeof(TelemetryRecord);
+
+	if (!mMemory.Create(name, size))
+	{
+		LOG("Failed to create telemetry shared memory %s", name);
+		return false;
+	}
+
+	char* data = static_cast<char*>(mMemory.GetData());
+
+	mHeader = new (data) TelemetryHeader();
+	mHeader->mVersion = TelemetryHeader::Version;
+	mHeader->mCapacity = capacity;
+	mHeader->mRecordSize = sizeof(TelemetryRecord);
+	mHeader->mWritten.store(0);
+	mHeader->mClosed.store(0);
+	// (last, readers wait for it)
+	std::atomic_thread_fence(std::memory_order_release);
+	mHeader->mMagic = TelemetryHeader::Magic;
+
+	mRecords = reinterpret_cast<TelemetryRecord*>(data + TelemetryHeader::DataOffset);
+	mWritten = 0;
+
+	LOG("Publishing telemetry to %s (%d frames)", name, capacity);
+	return true;
+}
+
+void Telemetry::Shutdown()
+{
+	if (mHeader)
+	{
+		// lets readers stop instead of waiting for more frames
+		mHeader->mClosed.store(1, std::memory_order_release);
+		mHeader = nullptr;
+		mRecords = nullptr;
+	}
+
+	mMemory.Close();
+}
+
+void Telemetry::Publish(const FrameStats& stats)
+{
+	if (!mHeader)
+	{
+		return;
+	}
+
+	TelemetryRecord& record = mRecords[mWritten % mHeader->mCapacity];
+	record.mFrame = mWritten + 1;
+	record.mFrameMs = stats.GetFrameTime(0);
+	record.mInputMs = stats.mInputMs;
+	record.mUpdateMs = stats.mUpdateMs;
+	record.mRenderMs = stats.mRenderMs;
+	record.mActors = stats.mActors;
+	record.mSprites = stats.mSprites;
+	record.mComponents = stats.mComponents;
+	record.mDrawCalls = stats.mDrawCalls;
+	record.mTextureSwitches = stats.mTextureSwitches;
+	record.mPad = 0;
+	record.mAllocs = stats.mAllocs;
+	record.mAllocBytes = stats.mAllocBytes;
+
+	mWritten++;
+	mHeader->mWritten.store(mWritten, std::memory_order_release);
+}
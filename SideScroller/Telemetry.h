@@ -0,0 +1,28 @@
+#pragma once
+#include "SharedMemory.h"
+#include "TelemetryFormat.h"
+
+// publishes every frame's FrameStats into a shared memory ring, for
+// the TelemetryReader tool (or anything else) to tail from outside
+// (publishing is a few stores into the mapping: no locks, no syscalls)
+class Telemetry
+{
+public:
+	Telemetry();
+	~Telemetry();
+
+	// creates the block with room for capacity frames
+	bool Initialize(const char* name, int capacity);
+	void Shutdown();
+
+	bool IsOpen() const { return mHeader != nullptr; }
+
+	void Publish(const struct FrameStats& stats);
+
+private:
+	SharedMemory mMemory;
+	TelemetryHeader* mHeader;
+	TelemetryRecord* mRecords;
+	// records published (mirrors mHeader->mWritten, which only we write)
+	uint64_t mWritten;
+};
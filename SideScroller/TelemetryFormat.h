@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// layout of the shared memory the game publishes frame metrics into
+// (also built into the TelemetryReader tool, so no SDL types here)
+
+// one frame, fixed size so the reader can index the ring directly
+struct TelemetryRecord
+{
+	// which frame this is, counting from one
+	uint64_t mFrame;
+
+	float mFrameMs;
+	float mInputMs;
+	float mUpdateMs;
+	float mRenderMs;
+
+	uint32_t mActors;
+	uint32_t mSprites;
+	uint32_t mComponents;
+	uint32_t mDrawCalls;
+	uint32_t mTextureSwitches;
+	uint32_t mPad;
+
+	uint64_t mAllocs;
+	uint64_t mAllocBytes;
+};
+
+static_assert(sizeof(TelemetryRecord) == 64, "telemetry records are a cache line");
+
+// at the start of the block, followed by mCapacity records at DataOffset
+// (there is a single writer: it fills record n's slot, n % mCapacity,
+// then releases mWritten = n + 1; a reader copies a slot and checks
+// mWritten again after, since the slot was only safe if the writer
+// hadn't come around to it yet)
+struct TelemetryHeader
+{
+	static const uint32_t Magic = 0x4d4c4554;
+	static const uint32_t Version = 1;
+	static const size_t DataOffset = 64;
+
+	uint32_t mMagic;
+	uint32_t mVersion;
+	uint32_t mCapacity;
+	uint32_t mRecordSize;
+	// records written so far
+	std::atomic<uint64_t> mWritten;
+	// set once the game has shut down
+	std::atomic<uint32_t> mClosed;
+};
+
+static_assert(sizeof(TelemetryHeader) <= TelemetryHeader::DataOffset, "telemetry header overlaps the records");
+
+// the block's default name
+#define TELEMETRY_NAME "SideScrollerTelemetry"
@@ -0,0 +1,22 @@
+#include "Texture.h"
+#include "TextureCache.h"
+
+Texture::Texture(TextureCache* cache, const std::string& path)
+	: mCache(cache)
+	, mCurrentFrame(&cache->mFrame)
+	, mPath(path)
+	, mTexture(nullptr)
+	, mReloadFailed(false)
+	, mWidth(0)
+	, mHeight(0)
+	, mFormat(SDL_PIXELFORMAT_UNKNOWN)
+	, mBlendClass(ETranslucent)
+	, mBytes(0)
+	, mLastUsedFrame(0)
+{
+}
+
+SDL_Texture* Texture::Reload()
+{
+	return mCache->Reload(this);
+}
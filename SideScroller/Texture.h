@@ -0,0 +1,72 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+// a texture owned by the TextureCache
+// (the handle stays valid while the SDL texture behind it is
+// evicted and reloaded, so sprites hold on to these instead)
+// size, format and blend class are filled in once at load, so
+// nothing needs to ask the driver about the texture afterwards
+class Texture
+{
+public:
+	// how the texture's alpha channel needs to be drawn
+	enum BlendClass
+	{
+		// every pixel fully opaque, drawn without blending
+		EOpaque,
+		// every pixel either fully opaque or fully transparent
+		ECutout,
+		// has partially transparent pixels
+		ETranslucent
+	};
+
+	Texture(class TextureCache* cache, const std::string& path);
+
+	// returns the SDL texture for drawing this frame,
+	// transparently reloading it if it was evicted
+	// (null, without trying again, once a reload has failed)
+	SDL_Texture* Acquire()
+	{
+		mLastUsedFrame = *mCurrentFrame;
+		return mTexture || mReloadFailed ? mTexture : Reload();
+	}
+
+	bool IsResident() const { return mTexture != nullptr; }
+	const std::string& GetPath() const { return mPath; }
+	int GetWidth() const { return mWidth; }
+	int GetHeight() const { return mHeight; }
+	// SDL_PIXELFORMAT_* of the texture
+	Uint32 GetFormat() const { return mFormat; }
+	BlendClass GetBlendClass() const { return mBlendClass; }
+	size_t GetBytes() const { return mBytes; }
+	Uint32 GetLastUsedFrame() const { return mLastUsedFrame; }
+
+	// premultiplied ARGB8888 pixels, width x height with no padding
+	// (only kept when the cache is asked to, otherwise null)
+	const Uint32* GetPixels() const { return mPixels.empty() ? nullptr : mPixels.data(); }
+
+private:
+	friend class TextureCache;
+
+	SDL_Texture* Reload();
+
+	class TextureCache* mCache;
+	// the cache's frame counter, for recency
+	const Uint32* mCurrentFrame;
+
+	std::string mPath;
+	// null while evicted
+	SDL_Texture* mTexture;
+	// (so a missing file isn't read again every frame)
+	bool mReloadFailed;
+	std::vector<Uint32> mPixels;
+
+	int mWidth;
+	int mHeight;
+	Uint32 mFormat;
+	BlendClass mBlendClass;
+	size_t mBytes;
+	Uint32 mLastUsedFrame;
+};
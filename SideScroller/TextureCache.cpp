@@ -0,0 +1,573 @@
+#include "TextureCache.h"
+#include "SDL_image.h"
+#include "ThreadPool.h"
+#include "Math.h"
+#include "AllocTracker.h"
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+#include "Logger.h"
+
+TextureCache::TextureCache()
+	: mSlots(64, Slot{ 0, 0 })
+	, mRenderer(nullptr)
+	, mPixelFormat(SDL_PIXELFORMAT_ARGB8888)
+	, mPremultiply(false)
+	, mTranslucentBlend(SDL_BLENDMODE_BLEND)
+	, mKeepPixels(false)
+	, mFrame(0)
+	, mFirstFrameDrawn(false)
+	, mStats()
+{
+}
+
+TextureCache::~TextureCache()
+{
+	Clear();
+}
+
+void TextureCache::SetRenderer(SDL_Renderer* renderer)
+{
+	mRenderer = renderer;
+
+	// use the first format the renderer takes natively that has alpha,
+	// so uploads and blits don't need to convert anything
+	mPixelFormat = SDL_PIXELFORMAT_ARGB8888;
+
+	SDL_RendererInfo info;
+
+	if (SDL_GetRendererInfo(renderer, &info) == 0)
+	{
+		for (Uint32 i = 0; i < info.num_texture_formats; i++)
+		{
+			Uint32 format = info.texture_formats[i];
+
+			if (!SDL_ISPIXELFORMAT_FOURCC(format) && SDL_ISPIXELFORMAT_ALPHA(format) &&
+				SDL_PIXELLAYOUT(format) == SDL_PACKEDLAYOUT_8888)
+			{
+				mPixelFormat = format;
+				break;
+			}
+		}
+	}
+
+	// premultiplied alpha needs a custom blend mode, which only
+	// some renderers support (test it on a throwaway texture)
+	mPremultiply = false;
+	mTranslucentBlend = SDL_BLENDMODE_BLEND;
+
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+	SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+	SDL_Texture* test = SDL_CreateTexture(renderer, mPixelFormat, SDL_TEXTUREACCESS_STATIC, 1, 1);
+
+	if (test)
+	{
+		if (SDL_SetTextureBlendMode(test, premultiplied) == 0)
+		{
+			mPremultiply = true;
+			mTranslucentBlend = premultiplied;
+		}
+
+		SDL_DestroyTexture(test);
+	}
+#endif
+}
+
+Texture* TextureCache::GetTexture(const AssetId& id)
+{
+	Slot& slot = FindSlot(id.GetHash());
+
+	// is the texture already in the table?
+	if (slot.mHash != 0)
+	{
+		// catch hash collisions between two different paths
+		SDL_assert(mEntries[slot.mEntry]->GetPath() == id.GetPath());
+		return mEntries[slot.mEntry];
+	}
+
+	AllocTracker::ScopeGuard scope(AllocTracker::EAssets);
+
+	if (mFirstFrameDrawn)
+	{
+		// the frame this is in will hitch
+		mStats.mLoadStalls++;
+		LOG("Texture load stall: %s", id.GetPath());
+	}
+
+	Image image;
+
+	if (!DecodeImage(id.GetPath(), image, mKeepPixels))
+	{
+		return nullptr;
+	}
+
+	SDL_Texture* sdlTex = CreateTexture(image, id.GetPath());
+
+	if (!sdlTex)
+	{
+		return nullptr;
+	}
+
+	Texture* tex = Insert(slot, id, image, sdlTex);
+	EnforceBudget();
+
+	return tex;
+}
+
+bool TextureCache::DecodePixels(const AssetId& id, std::vector<Uint32>& outPixels, int& outWidth, int& outHeight)
+{
+	AllocTracker::ScopeGuard scope(AllocTracker::EAssets);
+	Image image;
+
+	if (!DecodeImage(id.GetPath(), image, true))
+	{
+		return false;
+	}
+
+	outWidth = image.mSurface->w;
+	outHeight = image.mSurface->h;
+	outPixels.swap(image.mPixels);
+	SDL_FreeSurface(image.mSurface);
+
+	return true;
+}
+
+SDL_Texture* TextureCache::CreatePixelTexture(const Uint32* pixels, int width, int height)
+{
+	SDL_Texture* tex = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, width, height);
+
+	if (!tex)
+	{
+		LOG("Failed to create %dx%d texture: %s", width, height, SDL_GetError());
+		return nullptr;
+	}
+
+	if (mPremultiply)
+	{
+		SDL_UpdateTexture(tex, nullptr, pixels, width * 4);
+	}
+	else
+	{
+		// no premultiplied blend mode, so go back to straight alpha
+		std::vector<Uint32> straight(pixels, pixels + static_cast<size_t>(width) * height);
+
+		for (auto& pixel : straight)
+		{
+			Uint32 a = pixel >> 24;
+
+			if (a != 0 && a != 255)
+			{
+				Uint32 r = Math::Min<Uint32>(255, (((pixel >> 16) & 0xff) * 255 + a / 2) / a);
+				Uint32 g = Math::Min<Uint32>(255, (((pixel >> 8) & 0xff) * 255 + a / 2) / a);
+				Uint32 b = Math::Min<Uint32>(255, ((pixel & 0xff) * 255 + a / 2) / a);
+				pixel = (a << 24) | (r << 16) | (g << 8) | b;
+			}
+		}
+
+		SDL_UpdateTexture(tex, nullptr, straight.data(), width * 4);
+	}
+
+	SDL_SetTextureBlendMode(tex, mTranslucentBlend);
+
+	return tex;
+}
+
+int TextureCache::Preload(const std::string& manifestFile, ThreadPool& pool)
+{
+	AllocTracker::ScopeGuard scope(AllocTracker::EAssets);
+	std::ifstream file(manifestFile);
+
+	if (!file.is_open())
+	{
+		LOG("Failed to open asset manifest: %s", manifestFile.c_str());
+		return 0;
+	}
+
+	// gather the paths we don't have yet, each once
+	// (a hand-edited or merged manifest can repeat lines, and two
+	// decodes of one file would insert it twice)
+	std::vector<std::string> paths;
+	std::unordered_set<std::string> seen;
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		// tolerate manifests written on windows
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.pop_back();
+		}
+
+		if (!line.empty() && FindSlot(AssetId::Hash(line.c_str())).mHash == 0 && seen.insert(line).second)
+		{
+			paths.emplace_back(line);
+		}
+	}
+
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	// decoding is the slow part, so that is what gets spread out
+	std::vector<Image> images(paths.size(), Image{ nullptr, Texture::ETranslucent, {} });
+
+	pool.ParallelFor(paths.size(), [&](size_t i) {
+		DecodeImage(paths[i].c_str(), images[i], mKeepPixels);
+	});
+
+	// textures have to be created on the renderer's thread
+	int numLoaded = 0;
+
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		if (!images[i].mSurface)
+		{
+			continue;
+		}
+
+		SDL_Texture* sdlTex = CreateTexture(images[i], paths[i].c_str());
+
+		if (sdlTex)
+		{
+			AssetId id(paths[i].c_str());
+			Insert(FindSlot(id.GetHash()), id, images[i], sdlTex);
+			numLoaded++;
+		}
+	}
+
+	EnforceBudget();
+
+	float ms = (SDL_GetPerformanceCounter() - start) * 1000.0f / SDL_GetPerformanceFrequency();
+	LOG("Preloaded %d textures in %.1f ms on %d threads", numLoaded, ms, pool.GetNumThreads() + 1);
+
+	return numLoaded;
+}
+
+bool TextureCache::WriteManifest(const std::string& manifestFile) const
+{
+	std::ofstream file(manifestFile);
+
+	if (!file.is_open())
+	{
+		LOG("Failed to write asset manifest: %s", manifestFile.c_str());
+		return false;
+	}
+
+	for (auto tex : mEntries)
+	{
+		file << tex->GetPath() << '\n';
+	}
+
+	return true;
+}
+
+void TextureCache::BeginFrame()
+{
+	mFrame++;
+
+	// catch up on evictions deferred while last frame's
+	// textures were still in use
+	EnforceBudget();
+}
+
+void TextureCache::Clear()
+{
+	for (auto tex : mEntries)
+	{
+		if (tex->mTexture)
+		{
+			SDL_DestroyTexture(tex->mTexture);
+		}
+
+		delete tex;
+	}
+
+	mEntries.clear();
+	mStats.mResidentBytes = 0;
+	mStats.mResidentCount = 0;
+
+	for (auto& slot : mSlots)
+	{
+		slot.mHash = 0;
+	}
+}
+
+TextureCache::Slot& TextureCache::FindSlot(uint32_t hash)
+{
+	// linear probe from the hash's home slot until we hit
+	// either the matching hash or an empty slot
+	size_t mask = mSlots.size() - 1;
+	size_t i = hash & mask;
+
+	while (mSlots[i].mHash != 0 && mSlots[i].mHash != hash)
+	{
+		i = (i + 1) & mask;
+	}
+
+	return mSlots[i];
+}
+
+void TextureCache::Grow()
+{
+	std::vector<Slot> oldSlots;
+	oldSlots.swap(mSlots);
+	mSlots.assign(oldSlots.size() * 2, Slot{ 0, 0 });
+
+	for (auto& slot : oldSlots)
+	{
+		if (slot.mHash != 0)
+		{
+			FindSlot(slot.mHash) = slot;
+		}
+	}
+}
+
+Texture* TextureCache::Insert(Slot& slot, const AssetId& id, Image& image, SDL_Texture* sdlTex)
+{
+	Texture* tex = new Texture(this, id.GetPath());
+	// count as used now, so it isn't evicted before its first draw
+	tex->mLastUsedFrame = mFrame;
+	MakeResident(tex, image, sdlTex);
+
+	slot.mHash = id.GetHash();
+	slot.mEntry = static_cast<uint32_t>(mEntries.size());
+	mEntries.emplace_back(tex);
+
+	// grow before the table gets too full to probe quickly
+	if (mEntries.size() * 4 > mSlots.size() * 3)
+	{
+		Grow();
+	}
+
+	return tex;
+}
+
+// works out the blend class from the alpha channel and,
+// if asked, premultiplies the color channels by alpha
+// (surf must be a 32-bit format with 8-bit channels)
+static Texture::BlendClass ClassifyAlpha(SDL_Surface* surf, bool premultiply)
+{
+	const SDL_PixelFormat* fmt = surf->format;
+	bool anyTransparent = false;
+	bool anyPartial = false;
+
+	SDL_LockSurface(surf);
+
+	for (int y = 0; y < surf->h; y++)
+	{
+		Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surf->pixels) + y * surf->pitch);
+
+		for (int x = 0; x < surf->w; x++)
+		{
+			Uint32 pixel = row[x];
+			Uint32 a = (pixel & fmt->Amask) >> fmt->Ashift;
+
+			if (a == 255)
+			{
+				continue;
+			}
+
+			anyTransparent = true;
+			anyPartial = anyPartial || a != 0;
+
+			if (premultiply)
+			{
+				Uint32 r = (pixel & fmt->Rmask) >> fmt->Rshift;
+				Uint32 g = (pixel & fmt->Gmask) >> fmt->Gshift;
+				Uint32 b = (pixel & fmt->Bmask) >> fmt->Bshift;
+				r = (r * a + 127) / 255;
+				g = (g * a + 127) / 255;
+				b = (b * a + 127) / 255;
+				row[x] = (r << fmt->Rshift) | (g << fmt->Gshift) | (b << fmt->Bshift) | (a << fmt->Ashift);
+			}
+		}
+	}
+
+	SDL_UnlockSurface(surf);
+
+	if (!anyTransparent)
+	{
+		return Texture::EOpaque;
+	}
+
+	return anyPartial ? Texture::ETranslucent : Texture::ECutout;
+}
+
+// copies the surface's pixels out as ARGB8888, premultiplying
+// them if they aren't already
+static void KeepPixels(SDL_Surface* surf, bool premultiply, std::vector<Uint32>& outPixels)
+{
+	outPixels.resize(static_cast<size_t>(surf->w) * surf->h);
+
+	SDL_LockSurface(surf);
+	SDL_ConvertPixels(surf->w, surf->h, surf->format->format, surf->pixels, surf->pitch,
+		SDL_PIXELFORMAT_ARGB8888, outPixels.data(), surf->w * 4);
+	SDL_UnlockSurface(surf);
+
+	if (premultiply)
+	{
+		for (auto& pixel : outPixels)
+		{
+			Uint32 a = pixel >> 24;
+			Uint32 r = (((pixel >> 16) & 0xff) * a + 127) / 255;
+			Uint32 g = (((pixel >> 8) & 0xff) * a + 127) / 255;
+			Uint32 b = ((pixel & 0xff) * a + 127) / 255;
+			pixel = (a << 24) | (r << 16) | (g << 8) | b;
+		}
+	}
+}
+
+bool TextureCache::DecodeImage(const char* fileName, Image& outImage, bool keepPixels)
+{
+	// load from file
+	SDL_Surface* surf = IMG_Load(fileName);
+
+	if (!surf)
+	{
+		LOG("Failed to load texture file: %s", fileName);
+		return false;
+	}
+
+	// convert to the renderer's format now, instead of
+	// on every upload (or every blit, on the software renderer)
+	if (surf->format->format != mPixelFormat)
+	{
+		SDL_Surface* converted = SDL_ConvertSurfaceFormat(surf, mPixelFormat, 0);
+		SDL_FreeSurface(surf);
+
+		if (!converted)
+		{
+			LOG("Failed to convert pixel format for %s", fileName);
+			return false;
+		}
+
+		surf = converted;
+	}
+
+	outImage.mSurface = surf;
+	outImage.mBlendClass = ClassifyAlpha(surf, mPremultiply);
+
+	if (keepPixels)
+	{
+		KeepPixels(surf, !mPremultiply, outImage.mPixels);
+	}
+
+	return true;
+}
+
+SDL_Texture* TextureCache::CreateTexture(const Image& image, const char* fileName)
+{
+	// create texture from surface
+	SDL_Texture* tex = SDL_CreateTextureFromSurface(mRenderer, image.mSurface);
+	SDL_FreeSurface(image.mSurface);
+
+	if (!tex)
+	{
+		LOG("Failed to convert surface to texture for %s", fileName);
+		return nullptr;
+	}
+
+	// opaque textures skip blending entirely, which saves
+	// the read of the destination on every pixel
+	switch (image.mBlendClass)
+	{
+	case Texture::EOpaque:
+		SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_NONE);
+		break;
+	case Texture::ECutout:
+		// (premultiplied and straight alpha only differ on
+		// partially transparent pixels)
+		SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+		break;
+	case Texture::ETranslucent:
+		SDL_SetTextureBlendMode(tex, mTranslucentBlend);
+		break;
+	}
+
+	return tex;
+}
+
+SDL_Texture* TextureCache::Reload(Texture* tex)
+{
+	AllocTracker::ScopeGuard scope(AllocTracker::EAssets);
+	mStats.mReloads++;
+
+	if (mFirstFrameDrawn)
+	{
+		mStats.mLoadStalls++;
+	}
+
+	Image image;
+	SDL_Texture* sdlTex = nullptr;
+
+	if (DecodeImage(tex->GetPath().c_str(), image, mKeepPixels))
+	{
+		sdlTex = CreateTexture(image, tex->GetPath().c_str());
+	}
+
+	// (like a failed first load, it stays missing)
+	if (!sdlTex)
+	{
+		tex->mReloadFailed = true;
+		return nullptr;
+	}
+
+	MakeResident(tex, image, sdlTex);
+	EnforceBudget();
+
+	return sdlTex;
+}
+
+void TextureCache::MakeResident(Texture* tex, Image& image, SDL_Texture* sdlTex)
+{
+	// query once here, so nothing has to ask the driver later
+	SDL_QueryTexture(sdlTex, &tex->mFormat, nullptr, &tex->mWidth, &tex->mHeight);
+
+	tex->mTexture = sdlTex;
+	tex->mBlendClass = image.mBlendClass;
+	tex->mPixels.swap(image.mPixels);
+	tex->mBytes = static_cast<size_t>(tex->mWidth) * tex->mHeight * SDL_BYTESPERPIXEL(tex->mFormat);
+	tex->mBytes += tex->mPixels.size() * sizeof(Uint32);
+
+	mStats.mResidentBytes += tex->mBytes;
+	mStats.mResidentCount++;
+}
+
+void TextureCache::EnforceBudget()
+{
+	if (mStats.mBudgetBytes == 0)
+	{
+		return;
+	}
+
+	while (mStats.mResidentBytes > mStats.mBudgetBytes)
+	{
+		// find the least recently used texture
+		// (eviction is rare, so a scan beats keeping a list
+		// in order on every Acquire)
+		Texture* lru = nullptr;
+
+		for (auto tex : mEntries)
+		{
+			if (tex->mTexture && (!lru || tex->mLastUsedFrame < lru->mLastUsedFrame))
+			{
+				lru = tex;
+			}
+		}
+
+		// never evict what this frame is drawing with,
+		// the frame is allowed to go over budget instead
+		if (!lru || lru->mLastUsedFrame == mFrame)
+		{
+			break;
+		}
+
+		SDL_DestroyTexture(lru->mTexture);
+		lru->mTexture = nullptr;
+		std::vector<Uint32>().swap(lru->mPixels);
+
+		mStats.mResidentBytes -= lru->mBytes;
+		mStats.mResidentCount--;
+		mStats.mEvictions++;
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "AssetId.h"
+#include "Texture.h"
+
+// owns every loaded texture, keyed by AssetId
+// (lookups probe a flat open-addressing table of hashes, so they
+// never allocate or hash a string)
+class TextureCache
+{
+public:
+	struct Stats
+	{
+		size_t mResidentBytes;
+		size_t mBudgetBytes;
+		int mResidentCount;
+		int mEvictions;
+		int mReloads;
+		int mLoadStalls;
+	};
+
+	TextureCache();
+	~TextureCache();
+
+	// also picks the pixel format textures are converted to
+	void SetRenderer(SDL_Renderer* renderer);
+
+	// cap on resident texture memory (zero means no cap)
+	// once over it, the least recently drawn textures are evicted
+	void SetBudget(size_t bytes) { mStats.mBudgetBytes = bytes; }
+
+	// also keep a CPU-side copy of each texture's pixels
+	// (for the software rasterizer, set before loading anything)
+	void SetKeepPixels(bool keep) { mKeepPixels = keep; }
+
+	// returns the cached texture, loading it on first request
+	Texture* GetTexture(const AssetId& id);
+
+	// decodes a file into premultiplied ARGB8888 pixels, without
+	// making a texture of it (for building other textures from)
+	bool DecodePixels(const AssetId& id, std::vector<Uint32>& outPixels, int& outWidth, int& outHeight);
+	// uploads premultiplied ARGB8888 pixels as a translucent texture
+	// (owned by the caller, and not counted against the budget)
+	SDL_Texture* CreatePixelTexture(const Uint32* pixels, int width, int height);
+
+	// decodes every file listed in the manifest on the thread pool,
+	// then creates their textures (returns how many were loaded)
+	int Preload(const std::string& manifestFile, class ThreadPool& pool);
+	// writes the path of every texture requested so far, one per line
+	bool WriteManifest(const std::string& manifestFile) const;
+
+	// call once per frame before drawing
+	void BeginFrame();
+
+	// from now on, loads are counted as mid-game stalls
+	void MarkFirstFrame() { mFirstFrameDrawn = true; }
+	const Stats& GetStats() const { return mStats; }
+
+	// destroy all textures
+	void Clear();
+
+	size_t GetCount() const { return mEntries.size(); }
+
+private:
+	friend class Texture;
+
+	// a slot in the probe table (mHash of zero marks an empty slot)
+	struct Slot
+	{
+		uint32_t mHash;
+		uint32_t mEntry;
+	};
+
+	// a decoded file, converted and classified but not yet uploaded
+	struct Image
+	{
+		SDL_Surface* mSurface;
+		Texture::BlendClass mBlendClass;
+		// premultiplied ARGB8888 copy, if keeping pixels
+		std::vector<Uint32> mPixels;
+	};
+
+	Slot& FindSlot(uint32_t hash);
+	void Grow();
+	Texture* Insert(Slot& slot, const AssetId& id, Image& image, SDL_Texture* sdlTex);
+	// (safe to call from any thread)
+	bool DecodeImage(const char* fileName, Image& outImage, bool keepPixels);
+	SDL_Texture* CreateTexture(const Image& image, const char* fileName);
+
+	// fills in an evicted texture again
+	SDL_Texture* Reload(Texture* tex);
+	void MakeResident(Texture* tex, Image& image, SDL_Texture* sdlTex);
+	// evicts least recently used textures until under budget
+	void EnforceBudget();
+
+	// power of two sized, kept at most 3/4 full
+	std::vector<Slot> mSlots;
+	std::vector<Texture*> mEntries;
+
+	SDL_Renderer* mRenderer;
+	// what every surface is converted to before upload
+	Uint32 mPixelFormat;
+	// blend mode for premultiplied alpha, if the renderer has one
+	// (SDL's software renderer doesn't, so it keeps straight alpha)
+	bool mPremultiply;
+	SDL_BlendMode mTranslucentBlend;
+	bool mKeepPixels;
+
+	Uint32 mFrame;
+	bool mFirstFrameDrawn;
+	Stats mStats;
+};
@@ -0,0 +1,113 @@
+#include "ThreadPool.h"
+#include <SDL.h>
+#include "Profiler.h"
+
+ThreadPool::ThreadPool(int numThreads)
+	: mFunc(nullptr)
+	, mCount(0)
+	, mNext(0)
+	, mBusyWorkers(0)
+	, mGeneration(0)
+	, mQuit(false)
+{
+	if (numThreads <= 0)
+	{
+		// the calling thread does work too
+		numThreads = SDL_GetCPUCount() - 1;
+	}
+
+	for (int i = 0; i < numThreads; i++)
+	{
+		mThreads.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mQuit = true;
+	}
+
+	mWakeCV.notify_all();
+
+	for (auto& thread : mThreads)
+	{
+		thread.join();
+	}
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& func)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// not worth waking anyone for a single job
+	if (mThreads.empty() || count == 1)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			func(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFunc = &func;
+		mCount = count;
+		mNext = 0;
+		mBusyWorkers = static_cast<int>(mThreads.size());
+		mGeneration++;
+	}
+
+	mWakeCV.notify_all();
+
+	RunJobs();
+
+	// wait for the workers to finish their last job
+	std::unique_lock<std::mutex> lock(mMutex);
+	mDoneCV.wait(lock, [this] { return mBusyWorkers == 0; });
+	mFunc = nullptr;
+}
+
+void ThreadPool::WorkerLoop()
+{
+	unsigned seenGeneration = 0;
+	Profiler::SetThreadName("Worker");
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWakeCV.wait(lock, [&] { return mQuit || mGeneration != seenGeneration; });
+
+			if (mQuit)
+			{
+				return;
+			}
+
+			seenGeneration = mGeneration;
+		}
+
+		RunJobs();
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mBusyWorkers--;
+		}
+
+		mDoneCV.notify_one();
+	}
+}
+
+void ThreadPool::RunJobs()
+{
+	// grab indices until they run out
+	for (size_t i = mNext++; i < mCount; i = mNext++)
+	{
+		(*mFunc)(i);
+	}
+}
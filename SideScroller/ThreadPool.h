@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// a fixed set of worker threads that split up indexed jobs
+class ThreadPool
+{
+public:
+	// (zero threads means one per extra core)
+	ThreadPool(int numThreads = 0);
+	~ThreadPool();
+
+	// calls func(i) for every i in [0, count) across the workers
+	// and the calling thread, returns once all calls have finished
+	void ParallelFor(size_t count, const std::function<void(size_t)>& func);
+
+	int GetNumThreads() const { return static_cast<int>(mThreads.size()); }
+
+private:
+	void WorkerLoop();
+	void RunJobs();
+
+	std::vector<std::thread> mThreads;
+
+	std::mutex mMutex;
+	std::condition_variable mWakeCV;
+	std::condition_variable mDoneCV;
+
+	// the job currently being split up
+	const std::function<void(size_t)>* mFunc;
+	size_t mCount;
+	std::atomic<size_t> mNext;
+	// workers still inside RunJobs for this job
+	int mBusyWorkers;
+	// bumped for every job so sleeping workers know to wake
+	unsigned mGeneration;
+	bool mQuit;
+};
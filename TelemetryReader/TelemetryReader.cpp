@@ -0,0 +1,210 @@
+// TelemetryReader.cpp : tails the frame stats a running game publishes
+// with -telemetry, printing them or writing them out as CSV.
+//
+// usage: TelemetryReader [-csv file] [-name block] [-frames count]
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "SharedMemory.h"
+#include "TelemetryFormat.h"
+
+static volatile std::sig_atomic_t sStop = 0;
+
+static void OnInterrupt(int)
+{
+	sStop = 1;
+}
+
+static void Sleep(int ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// true once the game has finished setting up the block
+static bool IsReady(const SharedMemory& memory)
+{
+	if (memory.GetSize() < TelemetryHeader::DataOffset)
+	{
+		return false;
+	}
+
+	bool ready = static_cast<const TelemetryHeader*>(memory.GetData())->mMagic != 0;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return ready;
+}
+
+static void WriteRecord(FILE* file, bool csv, const TelemetryRecord& record)
+{
+	if (csv)
+	{
+		std::fprintf(file, "%llu,%.3f,%.3f,%.3f,%.3f,%u,%u,%u,%u,%u,%llu,%llu\n",
+			static_cast<unsigned long long>(record.mFrame),
+			record.mFrameMs, record.mInputMs, record.mUpdateMs, record.mRenderMs,
+			record.mActors, record.mSprites, record.mComponents,
+			record.mDrawCalls, record.mTextureSwitches,
+			static_cast<unsigned long long>(record.mAllocs),
+			static_cast<unsigned long long>(record.mAllocBytes));
+	}
+	else
+	{
+		std::fprintf(file, "frame %llu: %.2f ms (input %.2f, update %.2f, render %.2f), "
+			"%u actors, %u sprites, %u components, %u draws, %u switches, %llu allocs (%llu bytes)\n",
+			static_cast<unsigned long long>(record.mFrame),
+			record.mFrameMs, record.mInputMs, record.mUpdateMs, record.mRenderMs,
+			record.mActors, record.mSprites, record.mComponents,
+			record.mDrawCalls, record.mTextureSwitches,
+			static_cast<unsigned long long>(record.mAllocs),
+			static_cast<unsigned long long>(record.mAllocBytes));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const char* name = TELEMETRY_NAME;
+	const char* csvFile = nullptr;
+	// stop after this many records (zero for when the game exits)
+	unsigned long long maxRecords = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+		if (std::strcmp(argv[i], "-csv") == 0 && value)
+		{
+			csvFile = value;
+			i++;
+		}
+		else if (std::strcmp(argv[i], "-name") == 0 && value)
+		{
+			name = value;
+			i++;
+		}
+		else if (std::strcmp(argv[i], "-frames") == 0 && value)
+		{
+			maxRecords = std::strtoull(value, nullptr, 10);
+			i++;
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [-csv file] [-name block] [-frames count]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	std::signal(SIGINT, OnInterrupt);
+
+	FILE* out = stdout;
+
+	if (csvFile)
+	{
+		out = std::fopen(csvFile, "w");
+
+		if (!out)
+		{
+			std::fprintf(stderr, "Failed to open %s\n", csvFile);
+			return 1;
+		}
+
+		std::fprintf(out, "frame,frame_ms,input_ms,update_ms,render_ms,actors,sprites,components,draw_calls,texture_switches,allocs,alloc_bytes\n");
+	}
+
+	// the game may not be running yet
+	SharedMemory memory;
+	bool waiting = false;
+
+	while (!sStop && !(memory.Open(name) && IsReady(memory)))
+	{
+		if (!waiting)
+		{
+			std::fprintf(stderr, "Waiting for %s (run the game with -telemetry)...\n", name);
+			waiting = true;
+		}
+
+		Sleep(250);
+	}
+
+	if (sStop)
+	{
+		return 1;
+	}
+
+	const TelemetryHeader* header = static_cast<const TelemetryHeader*>(memory.GetData());
+
+	if (header->mMagic != TelemetryHeader::Magic ||
+		header->mVersion != TelemetryHeader::Version ||
+		header->mRecordSize != sizeof(TelemetryRecord) ||
+		memory.GetSize() < TelemetryHeader::DataOffset + header->mCapacity * sizeof(TelemetryRecord))
+	{
+		std::fprintf(stderr, "%s isn't a telemetry block this reader understands\n", name);
+		return 1;
+	}
+
+	const TelemetryRecord* records = reinterpret_cast<const TelemetryRecord*>(
+		static_cast<const char*>(memory.GetData()) + TelemetryHeader::DataOffset);
+	const uint64_t capacity = header->mCapacity;
+
+	// start from the oldest frame still in the ring
+	uint64_t next = header->mWritten.load(std::memory_order_acquire);
+	next = next > capacity ? next - capacity : 0;
+
+	unsigned long long read = 0;
+	unsigned long long dropped = 0;
+
+	while (!sStop && (maxRecords == 0 || read < maxRecords))
+	{
+		uint64_t written = header->mWritten.load(std::memory_order_acquire);
+
+		if (next == written)
+		{
+			if (header->mClosed.load(std::memory_order_acquire))
+			{
+				break;
+			}
+
+			Sleep(5);
+			continue;
+		}
+
+		// fell a whole ring behind, skip what was overwritten
+		if (written - next > capacity)
+		{
+			dropped += written - capacity - next;
+			next = written - capacity;
+		}
+
+		for (; next < written && (maxRecords == 0 || read < maxRecords); next++)
+		{
+			TelemetryRecord record = records[next % capacity];
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			// the writer may have come around to this slot while we
+			// copied it (the copy can't be trusted, and everything up
+			// to here is lost too)
+			if (header->mWritten.load(std::memory_order_relaxed) >= next + capacity)
+			{
+				dropped++;
+				continue;
+			}
+
+			WriteRecord(out, csvFile != nullptr, record);
+			read++;
+		}
+
+		std::fflush(out);
+	}
+
+	std::fprintf(stderr, "%llu frames read, %llu dropped\n", read, dropped);
+
+	if (out != stdout)
+	{
+		std::fclose(out);
+	}
+
+	return 0;
+}